@@ -14,12 +14,14 @@
 #endif
 
 #include "openmsg/memory_wrapper.hpp"
+#include "openmsg/simd.hpp"
 #include "openmsg/type_traits.hpp"
 #include "openmsg/user_definitions.hpp"
 
 #include <algorithm>
 #include <array>
 #include <compare>
+#include <cstring>
 #include <limits>
 #include <string>
 #include <string_view>
@@ -34,6 +36,8 @@ namespace detail_constexpr {
 template<typename T, size_t N>
 constexpr size_t array_len(const T(&src)[N]) noexcept
 {
+    if (!std::is_constant_evaluated())
+        return detail_simd::find_zero(reinterpret_cast<const std::byte*>(src), N);
     size_t i;
     for (i = 0; i < N; ++i)
         if (src[i] == 0)
@@ -56,6 +60,11 @@ template<typename T, size_t N, size_t Ns>
 constexpr std::strong_ordering array_strncmp(const T(&elems)[N], const T(&src_elems)[Ns]) noexcept
 {
     constexpr auto m = std::min(N, Ns);
+    if (!std::is_constant_evaluated())
+    {
+        auto i = detail_simd::find_mismatch(reinterpret_cast<const std::byte*>(elems), reinterpret_cast<const std::byte*>(src_elems), m);
+        return i == m ? std::strong_ordering::equal : elems[i] <=> src_elems[i];
+    }
     size_t i = 0;
     while (i < m)
     {
@@ -169,13 +178,13 @@ public:
     template<typename InputType>
     ArrayCharacter(const std::basic_string_view<InputType>& src) noexcept
     {
-        from_array_pointer(&*src.data(), src.size());
+        copy_from(&*src.data(), src.size());
     }
 
     template<typename InputType>
     ArrayCharacter& operator=(const std::basic_string_view<InputType>& src) noexcept
     {
-        from_array_pointer(&*src.data(), src.size());
+        copy_from(&*src.data(), src.size());
         return *this;
     }
 
@@ -183,17 +192,32 @@ public:
     ArrayCharacter& from_array_pointer(const InputType* src_elems, size_t max_size = std::numeric_limits<size_t>::max()) noexcept
     {
         // function name is intentionally long
-        max_size = std::min(max_size, size);
-        size_t i = 0;
-        for ( ; i < max_size && *src_elems != 0 ; ++i)
-            elems[i] = std::bit_cast<value_type>(src_elems[i]);
-        std::fill_n(elems + i, size - i, static_cast<value_type>(0));
+        static_assert(sizeof(InputType) == 1);
+        // src_elems may be a zero terminated string shorter than max_size, its extent is
+        // unknown: it is copied one byte at a time up to its zero (no vector load)
+        const auto n = std::min(max_size, size);
+        size_t length = 0;
+        for (; length < n && src_elems[length] != 0; ++length)
+            elems[length] = static_cast<value_type>(src_elems[length]);
+        detail_simd::zero_n<size>(reinterpret_cast<std::byte*>(elems) + length, size - length);
         if (is_zero_terminated)
             elems[size - 1] = 0;
         return *this;
     }
 
     value_type elems[size];
+
+private:
+    // [src_elems, src_elems + src_size) is readable
+    template<typename InputType>
+    ArrayCharacter& copy_from(const InputType* src_elems, size_t src_size) noexcept
+    {
+        static_assert(sizeof(InputType) == 1);
+        detail_simd::copy_zero_padded<size>(reinterpret_cast<const std::byte*>(src_elems), std::min(src_size, size), reinterpret_cast<std::byte*>(elems));
+        if (is_zero_terminated)
+            elems[size - 1] = 0;
+        return *this;
+    }
 };
 
 template<size_t N, bool IsZeroTerminated = false>
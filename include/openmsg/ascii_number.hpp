@@ -0,0 +1,222 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/array_char.hpp"
+#include "openmsg/concepts.hpp"
+#include "openmsg/decimal.hpp"
+#include "openmsg/simd.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+#include <limits>
+
+namespace openmsg {
+
+// Numbers sent as fixed width ASCII in ArrayCharacter fields (up to 32 characters), e.g.
+// quantities, prices and ids:
+//
+//     int64_t quantity;
+//     if (!to_integer(msg.quantity, quantity))  // "00001500", "  1500", "1500    "...
+//         return;
+//     to_decimal(msg.price, price);             // "-12.50" into a Decimal (see decimal.hpp)
+//     from_integer(reply.quantity, quantity, Padding::zero);
+//
+// Leading spaces and trailing spaces or zero bytes are ignored, a '-' (signed integers
+// and decimals) or '+' may precede the digits, decimals may have a '.'. The digits are
+// right aligned in a 16 or 32-byte block of '0', which is validated and parsed 16 digits
+// at a time (SSSE3, or 8 at a time as 64-bit words), rather than one character at a time.
+// Formatting writes 8 digits at a time as 64-bit words.
+
+// layout of a number written into a field
+enum class Padding : int
+{
+    zero,            // right aligned, leading '0' (after the sign)
+    space,           // right aligned, leading spaces
+    trailing_space,  // left aligned, trailing spaces
+    trailing_null,   // left aligned, trailing zero bytes (as ArrayCharacter strings)
+};
+
+namespace detail_ascii {
+
+constexpr size_t max_field_size = 32;
+
+struct Number
+{
+    uint64_t magnitude = 0;
+    bool negative = false;
+    int fraction_digits = 0;
+};
+
+// bit i of the mask is set if src[i] == value, for a 32-byte block
+inline uint64_t match32(const std::byte* src, uint8_t value) noexcept
+{
+    return detail_simd::match_byte16(src, value) | uint64_t{ detail_simd::match_byte16(src + 16, value) } << 16;
+}
+
+// number in [src, src + n), n <= 32, false if it is not one (or does not fit in a uint64_t)
+inline bool parse(const std::byte* src, size_t n, bool is_signed, bool has_point, Number& number) noexcept
+{
+    std::byte block[max_field_size] = {};
+    std::memcpy(block, src, n);
+
+    // trimmed [first, last)
+    const uint64_t field = (uint64_t{ 1 } << n) - 1;
+    const auto spaces = match32(block, ' ') & field;
+    const auto first = static_cast<size_t>(std::countr_one(spaces));
+    const auto padding = spaces | (match32(block, 0) & field) | ~field;
+    const auto last = 64 - static_cast<size_t>(std::countl_one(padding));
+    if (first >= last)
+        return false;
+
+    size_t begin = first;
+    if (block[begin] == std::byte{ '-' } && is_signed)
+    {
+        number.negative = true;
+        ++begin;
+    }
+    else if (block[begin] == std::byte{ '+' })
+        ++begin;
+
+    // digits, without the point
+    size_t point = last;
+    if (has_point)
+    {
+        const auto points = match32(block, '.') & (field << begin) & field;
+        if (std::popcount(points) > 1)
+            return false;
+        if (points != 0)
+            point = static_cast<size_t>(std::countr_zero(points));
+    }
+    const auto integer_digits = point - begin;
+    const auto fraction_digits = point < last ? last - point - 1 : 0;
+    const auto digits = integer_digits + fraction_digits;
+    if (digits == 0)
+        return false;
+    number.fraction_digits = static_cast<int>(fraction_digits);
+
+    std::byte aligned[max_field_size];
+    std::memset(aligned, '0', sizeof(aligned));
+    std::memcpy(aligned + max_field_size - digits, block + begin, integer_digits);
+    std::memcpy(aligned + max_field_size - fraction_digits, block + point + 1, fraction_digits);
+
+    uint64_t low;
+    if (!detail_simd::parse_digits16(aligned + 16, low))
+        return false;
+    if (digits <= 16)
+    {
+        number.magnitude = low;
+        return true;
+    }
+    uint64_t high;
+    if (!detail_simd::parse_digits16(aligned, high))
+        return false;
+    constexpr uint64_t limit = std::numeric_limits<uint64_t>::max() / 10'000'000'000'000'000ull;
+    if (high > limit || (high == limit && low > std::numeric_limits<uint64_t>::max() % 10'000'000'000'000'000ull))
+        return false;
+    number.magnitude = high * 10'000'000'000'000'000ull + low;
+    return true;
+}
+
+template<any_integral T>
+constexpr bool to_value(const Number& number, T& value) noexcept
+{
+    using U = std::make_unsigned_t<T>;
+    const auto max = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (number.negative ? 1 : 0);
+    if (number.magnitude > max)
+        return false;
+    value = static_cast<T>(number.negative ? static_cast<U>(0 - static_cast<U>(number.magnitude)) : static_cast<U>(number.magnitude));
+    return true;
+}
+
+// magnitude right aligned at the end of a 32-byte block, returns its number of digits
+inline size_t format(uint64_t magnitude, std::byte* block) noexcept
+{
+    constexpr uint64_t p16 = 10'000'000'000'000'000ull;
+    detail_simd::format_digits16(magnitude % p16, block + 16);
+    detail_simd::format_digits16(magnitude / p16, block);
+    size_t digits = 1;
+    for (uint64_t power = 10; digits < 20 && magnitude >= power; power *= 10)
+        ++digits;
+    return digits;
+}
+
+}  // namespace detail_ascii
+
+// integer of the field, false if it is not one or if it does not fit in a T (value is then left as it is)
+template<any_integral T, typename C, size_t N, bool Z>
+requires (N <= detail_ascii::max_field_size)
+inline bool to_integer(const ArrayCharacter<C, N, Z>& field, T& value) noexcept
+{
+    detail_ascii::Number number;
+    if (!detail_ascii::parse(reinterpret_cast<const std::byte*>(field.elems), N, signed_integral<T>, false, number))
+        return false;
+    return detail_ascii::to_value(number, value);
+}
+
+// decimal of the field (see from_scaled() in decimal.hpp, e.g. rescaled to a constant exponent)
+template<decimal D, typename C, size_t N, bool Z>
+requires (N <= detail_ascii::max_field_size)
+inline bool to_decimal(const ArrayCharacter<C, N, Z>& field, D& value) noexcept
+{
+    detail_ascii::Number number;
+    if (!detail_ascii::parse(reinterpret_cast<const std::byte*>(field.elems), N, true, true, number))
+        return false;
+    int64_t mantissa;
+    return detail_ascii::to_value(number, mantissa) && from_scaled(value, mantissa, -number.fraction_digits);
+}
+
+// field = value laid out as padding says, false if it does not fit (the field is then left as it is)
+template<any_integral T, typename C, size_t N, bool Z>
+requires (N <= detail_ascii::max_field_size)
+inline bool from_integer(ArrayCharacter<C, N, Z>& field, T value, Padding padding = Padding::zero) noexcept
+{
+    using U = std::make_unsigned_t<T>;
+    constexpr size_t width = Z ? N - 1 : N;
+    const bool negative = value < 0;
+    const uint64_t magnitude = negative ? static_cast<U>(0 - static_cast<U>(value)) : static_cast<U>(value);
+    std::byte block[detail_ascii::max_field_size];
+    const auto digits = detail_ascii::format(magnitude, block);
+    const auto size = digits + negative;
+    if (size > width)
+        return false;
+
+    std::byte text[detail_ascii::max_field_size];
+    if (padding == Padding::zero)
+    {
+        std::memcpy(text, block + detail_ascii::max_field_size - width, width);  // leading '0' included
+        if (negative)
+            text[0] = std::byte{ '-' };
+    }
+    else if (padding == Padding::space)
+    {
+        std::memset(text, ' ', width - size);
+        if (negative)
+            text[width - size] = std::byte{ '-' };
+        std::memcpy(text + width - digits, block + detail_ascii::max_field_size - digits, digits);
+    }
+    else
+    {
+        if (negative)
+            text[0] = std::byte{ '-' };
+        std::memcpy(text + negative, block + detail_ascii::max_field_size - digits, digits);
+        std::memset(text + size, padding == Padding::trailing_space ? ' ' : 0, width - size);
+    }
+    std::memcpy(field.elems, text, width);
+    return true;
+}
+
+}  // namespace openmsg
@@ -0,0 +1,278 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/attributes.hpp"
+#include "openmsg/bounds.hpp"
+#include "openmsg/concepts.hpp"
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/presence.hpp"
+#include "openmsg/reflection.hpp"
+#include "openmsg/type_traits.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <inttypes.h>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace openmsg {
+
+// Sub-byte fields packed into one wire word, e.g. the version and header length of an
+// IPv4 header:
+//
+//     struct Ipv4Header
+//     {
+//         BitPack<be_uint8_t, BitField<"version", 4, 4>, BitField<"ihl", 0, 4>> versionIhl;
+//         ...
+//     };
+//
+//     auto version = header.versionIhl.get<"version">();
+//     header.versionIhl.set<"ihl">(5);              // the version is left as it is
+//     auto [v, ihl] = header.versionIhl.unpack();   // the word is loaded (and swapped) once
+//
+// A BitField is Width bits at Offset (from the least significant bit) of the host value
+// of the word. Its value is unsigned by default (the smallest type holding Width bits),
+// signed values are sign extended, enums are stored as their underlying type. Bounds
+// are those of the attributes, by default what Width bits can hold:
+//
+//     BitField<"side", 0, 2, Side, Attributes<Side, Presence::required, Side{ 3 }, Side::Buy, Side::Sell>>
+//
+// Values written are truncated to Width bits.
+
+namespace detail_bitfield {
+
+template<size_t Width>
+requires (Width > 0 && Width <= 64)
+using uint_of_width_t = uint_of_size_t<std::bit_ceil((Width + 7) / 8)>;
+
+constexpr uint64_t low_mask(size_t width) noexcept
+{
+    return width == 64 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << width) - 1;
+}
+
+template<typename T> struct integer_of { using type = T; };
+template<enumerated T> struct integer_of<T> { using type = std::underlying_type_t<T>; };
+template<typename T> using integer_of_t = typename integer_of<T>::type;
+
+// range of Width bits for integers, range of the type otherwise
+template<swappable T, size_t Width>
+constexpr auto width_attributes() noexcept
+{
+    if constexpr (unsigned_integral<T> && Width < sizeof(T) * 8)
+        return std::type_identity<Attributes<T, Presence::required, bounds<T>::nullValue, T{ 0 }, static_cast<T>(low_mask(Width))>>{};
+    else if constexpr (signed_integral<T> && Width < sizeof(T) * 8)
+        return std::type_identity<Attributes<T, Presence::required, bounds<T>::nullValue,
+                                             static_cast<T>(-static_cast<int64_t>(low_mask(Width - 1)) - 1), static_cast<T>(low_mask(Width - 1))>>{};
+    else
+        return std::type_identity<Attributes<T>>{};
+}
+
+template<swappable T, size_t Width>
+using width_attributes_t = typename decltype(width_attributes<T, Width>())::type;
+
+}  // namespace detail_bitfield
+
+template<fixed_string _name,
+         size_t _offset,
+         size_t _width,
+         swappable T = detail_bitfield::uint_of_width_t<_width>,
+         has_attributes _attributes = detail_bitfield::width_attributes_t<T, _width>>
+requires (_width > 0 && _offset + _width <= 64 && _width <= sizeof(T) * 8 && !std::floating_point<T> &&
+          std::is_same_v<T, typename _attributes::value_type>)
+struct BitField : _attributes
+{
+    using value_type = T;
+    using attributes = _attributes;
+    constexpr static std::string_view name = _name.view();
+    constexpr static size_t offset = _offset;
+    constexpr static size_t width = _width;
+    constexpr static bool is_optional = BitField::presence == Presence::optional;
+
+    // bits of the field in a word
+    template<unsigned_integral S>
+    constexpr static S mask = static_cast<S>(detail_bitfield::low_mask(width) << offset);
+
+    template<unsigned_integral S>
+    constexpr static value_type extract(S word) noexcept
+    {
+        using I = detail_bitfield::integer_of_t<T>;
+        const uint64_t bits = (static_cast<uint64_t>(word) >> offset) & detail_bitfield::low_mask(width);
+        if constexpr (std::is_signed_v<I> && width < 64)
+            return static_cast<T>(static_cast<I>(static_cast<int64_t>(bits << (64 - width)) >> (64 - width)));
+        else
+            return static_cast<T>(static_cast<I>(bits));
+    }
+
+    // word with the field replaced by value, the other bits are kept
+    template<unsigned_integral S>
+    constexpr static S insert(S word, value_type value) noexcept
+    {
+        using I = detail_bitfield::integer_of_t<T>;
+        const auto bits = static_cast<uint64_t>(static_cast<I>(value)) & detail_bitfield::low_mask(width);
+        return static_cast<S>((word & static_cast<S>(~mask<S>)) | static_cast<S>(bits << offset));
+    }
+
+    constexpr static bool in_bound(value_type value) noexcept
+    {
+        using I = detail_bitfield::integer_of_t<T>;
+        bool valid = (static_cast<I>(BitField::minValue) <= static_cast<I>(value)) & (static_cast<I>(value) <= static_cast<I>(BitField::maxValue));
+        if constexpr (is_optional)
+            valid |= static_cast<I>(value) == static_cast<I>(BitField::nullValue);
+        return valid;
+    }
+};
+
+template<typename T> struct is_bit_field : std::false_type {};
+template<fixed_string _name, size_t _offset, size_t _width, swappable T, has_attributes _attributes>
+struct is_bit_field<BitField<_name, _offset, _width, T, _attributes>> : std::true_type {};
+
+template<typename T> concept bit_field = is_bit_field<T>::value;
+
+namespace detail_bitfield {
+
+template<typename S, typename... Fields>
+constexpr bool disjoint() noexcept
+{
+    return (std::popcount(Fields::template mask<S>) + ... + 0) == std::popcount(static_cast<S>((Fields::template mask<S> | ... | S{ 0 })));
+}
+
+template<typename... Fields>
+constexpr size_t index_of(std::string_view name) noexcept
+{
+    constexpr std::string_view names[] = { Fields::name... };
+    for (size_t i = 0; i < sizeof...(Fields); ++i)
+        if (names[i] == name)
+            return i;
+    return sizeof...(Fields);
+}
+
+template<size_t I, typename First, typename... Rest>
+struct nth : nth<I - 1, Rest...> {};
+template<typename First, typename... Rest>
+struct nth<0, First, Rest...> { using type = First; };
+
+}  // namespace detail_bitfield
+
+#pragma pack(push, 1)
+
+// Fields sharing one wire word W (an EndianWrapper of an unsigned integer): the word is
+// loaded and swapped once per access, a field is set with a single read-modify-write.
+template<endian_wrapper W, bit_field... Fields>
+requires (unsigned_integral<typename W::value_type> && !W::is_optional && sizeof...(Fields) > 0 &&
+          ((Fields::offset + Fields::width <= sizeof(typename W::value_type) * 8) && ...) &&
+          detail_bitfield::disjoint<typename W::value_type, Fields...>())
+struct BitPack
+{
+    using wrapper_type = W;
+    using value_type = typename W::value_type;  // host word
+    constexpr static size_t field_count = sizeof...(Fields);
+    template<size_t I> using field_t = typename detail_bitfield::nth<I, Fields...>::type;
+
+    constexpr BitPack() noexcept = default;
+
+    constexpr BitPack(value_type word) noexcept
+        : m_word(word)
+    {
+    }
+
+    // word made of the values of all the fields (in declaration order), the other bits are zero
+    constexpr static BitPack make(typename Fields::value_type... values) noexcept
+    {
+        value_type word = 0;
+        ((word = Fields::insert(word, values)), ...);
+        return BitPack(word);
+    }
+
+    // host word
+    constexpr value_type operator()() const noexcept
+    {
+        return m_word();
+    }
+
+    template<bit_field F>
+    requires is_any_of<F, Fields...>
+    constexpr typename F::value_type get() const noexcept
+    {
+        return F::extract(m_word());
+    }
+
+    template<size_t I>
+    requires (I < field_count)
+    constexpr auto get() const noexcept
+    {
+        return get<field_t<I>>();
+    }
+
+    template<fixed_string Name>
+    requires (detail_bitfield::index_of<Fields...>(Name.view()) < field_count)
+    constexpr auto get() const noexcept
+    {
+        return get<detail_bitfield::index_of<Fields...>(Name.view())>();
+    }
+
+    template<bit_field F>
+    requires is_any_of<F, Fields...>
+    constexpr void set(typename F::value_type value) noexcept
+    {
+        m_word = F::insert(m_word(), value);
+    }
+
+    template<size_t I>
+    requires (I < field_count)
+    constexpr void set(typename field_t<I>::value_type value) noexcept
+    {
+        set<field_t<I>>(value);
+    }
+
+    template<fixed_string Name>
+    requires (detail_bitfield::index_of<Fields...>(Name.view()) < field_count)
+    constexpr void set(typename field_t<detail_bitfield::index_of<Fields...>(Name.view())>::value_type value) noexcept
+    {
+        set<detail_bitfield::index_of<Fields...>(Name.view())>(value);
+    }
+
+    // values of all the fields, in declaration order
+    constexpr std::tuple<typename Fields::value_type...> unpack() const noexcept
+    {
+        const value_type word = m_word();
+        return { Fields::extract(word)... };
+    }
+
+    // all the fields are within their attributes' bounds
+    constexpr bool in_bound() const noexcept
+    {
+        const value_type word = m_word();
+        return (Fields::in_bound(Fields::extract(word)) & ...);
+    }
+
+    constexpr const W& storage_value() const noexcept
+    {
+        return m_word;
+    }
+
+private:
+    W m_word;
+};
+
+#pragma pack(pop)
+
+template<typename T> struct is_bit_pack : std::false_type {};
+template<endian_wrapper W, bit_field... Fields>
+struct is_bit_pack<BitPack<W, Fields...>> : std::true_type {};
+
+template<typename T> concept bit_pack = is_bit_pack<T>::value;
+
+}  // namespace openmsg
@@ -0,0 +1,167 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/memory_wrapper.hpp"
+#include "openmsg/simd.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace openmsg {
+
+// Memory wrappers storing the plain byte reversal of the host value, for which
+// bulk conversions can use the SIMD kernels. Other memory wrappers are converted
+// one value at a time through their own mtoh()/htom() (users may specialise it).
+
+template<typename MemoryWrapper> struct is_bswap_memory_wrapper : std::false_type {};
+template<swappable HostType, std::endian _endian>
+struct is_bswap_memory_wrapper<memory_wrapper_bswap<HostType, _endian>> : std::true_type {};
+template<swappable HostType, std::endian _endian>
+struct is_bswap_memory_wrapper<memory_wrapper_robust<HostType, _endian>> : std::true_type {};
+template<swappable HostType, std::endian _endian>
+struct is_bswap_memory_wrapper<memory_wrapper_movbe<HostType, _endian>> : std::true_type {};
+
+// Hint for the stores done by htom(), non-temporal stores bypass the cache and
+// are better suited to large outputs which will not be read back soon
+
+enum class StoreHint : int
+{
+    temporal = 0,
+    non_temporal = 1,
+    automatic = 2,  // non_temporal from non_temporal_threshold bytes
+};
+
+constexpr size_t non_temporal_threshold = 1024 * 1024;
+
+namespace detail_bulk {
+
+template<endian_wrapper W>
+constexpr bool is_bulk = is_bswap_memory_wrapper<typename W::memory_wrapper>::value;
+
+// convert n values, either with a copy or a byte swap (src and dst may be the same)
+template<endian_wrapper W>
+inline void convert(const std::byte* src, std::byte* dst, size_t n) noexcept
+{
+    if (n == 0)
+        return;
+    if constexpr (sizeof(W) == 1 || W::endian == std::endian::native)
+    {
+        if (src != dst)
+            std::memcpy(dst, src, n * sizeof(W));
+    }
+    else
+        detail_simd::bswap_n<sizeof(W)>(src, dst, n);
+}
+
+template<endian_wrapper W>
+inline void stream(const std::byte* src, std::byte* dst, size_t n) noexcept
+{
+    if (n == 0)  // src and dst may be null (empty spans)
+        return;
+    if constexpr (W::endian == std::endian::native)
+        detail_simd::stream_n<1>(src, dst, n * sizeof(W));
+    else
+        detail_simd::stream_n<sizeof(W)>(src, dst, n);
+}
+
+}  // namespace detail_bulk
+
+// mtoh (message to host) of contiguous values, returns the number of converted values
+
+template<endian_wrapper W>
+constexpr size_t mtoh(std::span<const W> src, std::span<typename W::value_type> dst) noexcept
+{
+    const auto n = std::min(src.size(), dst.size());
+    if (std::is_constant_evaluated() || !detail_bulk::is_bulk<W>)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = src[i]();
+        return n;
+    }
+    detail_bulk::convert<W>(reinterpret_cast<const std::byte*>(src.data()), reinterpret_cast<std::byte*>(dst.data()), n);
+    return n;
+}
+
+template<endian_wrapper W, size_t N>
+constexpr void mtoh(const W(&src)[N], typename W::value_type(&dst)[N]) noexcept
+{
+    mtoh(std::span<const W>(src), std::span<typename W::value_type>(dst));
+}
+
+// mtoh in place, values hold the memory representation (e.g. copied from a buffer)
+
+template<endian_wrapper W>
+constexpr void mtoh(std::span<typename W::value_type> values) noexcept
+{
+    using memory_type = typename W::memory_type;
+    if (std::is_constant_evaluated() || !detail_bulk::is_bulk<W>)
+    {
+        for (auto& value : values)
+            value = W::memory_wrapper::mtoh(std::bit_cast<memory_type>(value));
+        return;
+    }
+    auto p = reinterpret_cast<std::byte*>(values.data());
+    detail_bulk::convert<W>(p, p, values.size());
+}
+
+// htom (host to message) of contiguous values, returns the number of converted values
+
+template<endian_wrapper W>
+constexpr size_t htom(std::span<const typename W::value_type> src, std::span<W> dst, StoreHint hint = StoreHint::automatic) noexcept
+{
+    const auto n = std::min(src.size(), dst.size());
+    if (std::is_constant_evaluated() || !detail_bulk::is_bulk<W>)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = W(src[i]);
+        return n;
+    }
+    auto from = reinterpret_cast<const std::byte*>(src.data());
+    auto to = reinterpret_cast<std::byte*>(dst.data());
+    if (hint == StoreHint::non_temporal || (hint == StoreHint::automatic && n * sizeof(W) >= non_temporal_threshold))
+        detail_bulk::stream<W>(from, to, n);
+    else
+        detail_bulk::convert<W>(from, to, n);
+    return n;
+}
+
+template<endian_wrapper W, size_t N>
+constexpr void htom(const typename W::value_type(&src)[N], W(&dst)[N], StoreHint hint = StoreHint::automatic) noexcept
+{
+    htom(std::span<const typename W::value_type>(src), std::span<W>(dst), hint);
+}
+
+// htom in place, values are converted to their memory representation (e.g. to be copied to a buffer)
+
+template<endian_wrapper W>
+constexpr void htom(std::span<typename W::value_type> values) noexcept
+{
+    using value_type = typename W::value_type;
+    if (std::is_constant_evaluated() || !detail_bulk::is_bulk<W>)
+    {
+        for (auto& value : values)
+            value = std::bit_cast<value_type>(W::memory_wrapper::htom(value));
+        return;
+    }
+    auto p = reinterpret_cast<std::byte*>(values.data());
+    detail_bulk::convert<W>(p, p, values.size());
+}
+
+}  // namespace openmsg
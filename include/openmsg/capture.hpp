@@ -0,0 +1,128 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/mapped_file.hpp"
+#include "openmsg/message_view.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+namespace openmsg {
+
+// A record of a capture file, i.e. a payload following its length prefix
+
+struct CaptureRecord
+{
+    std::span<const std::byte> payload;
+
+    template<wire_message Msg>
+    MessageView<Msg> view(size_t block_length = sizeof(Msg)) const noexcept
+    {
+        return MessageView<Msg>(payload, block_length);
+    }
+};
+
+// Zero-copy reader of captures made of [Length][payload] records, Length being an
+// EndianWrapper (e.g. BigEndian<uint32_t>) holding the size of the payload. The reader
+// walks a buffer, typically a MappedFile:
+//
+//     MappedFile file("capture.bin");
+//     CaptureReader<BigEndian<uint32_t>> reader(file.data());
+//     CaptureRecord records[64];
+//     while (size_t n = reader.next(records))  // batches of up to 64 records
+//         for (const auto& record : std::span(records, n))
+//             decode(record.view<Msg>());
+//
+// The bytes prefetch_distance ahead of the current record are prefetched. Reading stops
+// at the first truncated record (valid() is then false, and tail() starts at that record).
+
+template<endian_wrapper Length>
+requires std::is_integral_v<typename Length::value_type>
+class CaptureReader
+{
+public:
+    using length_type = Length;
+    constexpr static size_t default_prefetch_distance = 512;
+
+    CaptureReader() noexcept = default;
+
+    explicit CaptureReader(std::span<const std::byte> buffer, size_t prefetch_distance = default_prefetch_distance) noexcept
+        : m_buffer(buffer), m_prefetch_distance(prefetch_distance)
+    {
+    }
+
+    // next record, false at the end of the buffer or on a truncated record
+    bool next(CaptureRecord& record) noexcept
+    {
+        if (m_position + sizeof(Length) > m_buffer.size())
+        {
+            m_valid = m_position == m_buffer.size();
+            return false;
+        }
+        Length length;
+        std::memcpy(&length, m_buffer.data() + m_position, sizeof(Length));
+        const auto size = static_cast<size_t>(length());
+        if (size > m_buffer.size() - m_position - sizeof(Length))
+        {
+            m_valid = false;
+            return false;
+        }
+        if (m_prefetch_distance != 0 && m_position + m_prefetch_distance < m_buffer.size())
+            prefetch(m_buffer.data() + m_position + m_prefetch_distance);
+        record.payload = m_buffer.subspan(m_position + sizeof(Length), size);
+        m_position += sizeof(Length) + size;
+        ++m_count;
+        return true;
+    }
+
+    // next records (up to records.size()), returns the number of records read
+    size_t next(std::span<CaptureRecord> records) noexcept
+    {
+        size_t n = 0;
+        while (n < records.size() && next(records[n]))
+            ++n;
+        return n;
+    }
+
+    // false if a truncated record was found
+    bool valid() const noexcept { return m_valid; }
+    explicit operator bool() const noexcept { return m_valid; }
+
+    bool at_end() const noexcept { return m_position == m_buffer.size(); }
+
+    // records read so far
+    size_t count() const noexcept { return m_count; }
+
+    // what has not been read
+    std::span<const std::byte> tail() const noexcept { return m_buffer.subspan(m_position); }
+
+    void rewind() noexcept
+    {
+        m_position = 0;
+        m_count = 0;
+        m_valid = true;
+    }
+
+private:
+    std::span<const std::byte> m_buffer;
+    size_t m_position = 0;
+    size_t m_count = 0;
+    size_t m_prefetch_distance = default_prefetch_distance;
+    bool m_valid = true;
+};
+
+}  // namespace openmsg
@@ -0,0 +1,139 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/bitfield.hpp"
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/simd.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+#include <span>
+
+namespace openmsg {
+
+// Internet checksum (RFC 1071), the ones' complement of the ones' complement sum of the
+// big endian 16-bit words of the data, e.g. of IPv4 headers, UDP and TCP segments.
+// Values are host values of these big endian words, i.e. what a be_uint16_t holds:
+//
+//     header.checksum = 0;
+//     header.checksum = internet_checksum(header_bytes);
+//
+// Sums of several spans (e.g. a pseudo-header and a segment) are combined with
+// ones_complement_add(), every span but the last one having an even size.
+//
+// A field covered by a checksum is rewritten with set_checksummed(), which updates the
+// checksum incrementally (RFC 1624) from the old and new bytes of the field, rather than
+// summing all the data again:
+//
+//     set_checksummed(tcp.destinationPort, 8080, tcp.checksum);
+//
+// UDP checksums are updated with set_udp_checksummed(): a UDP checksum of 0 means there
+// is no checksum (it is left at 0), and a computed 0 is sent as 0xFFFF.
+
+namespace detail_checksum {
+
+// ones' complement sum, as a host value of the big endian words
+inline uint16_t sum(const std::byte* data, size_t n) noexcept
+{
+    const auto folded = detail_simd::add_carries(detail_simd::ones_sum(data, n));
+    if constexpr (std::endian::native == std::endian::little)
+        return static_cast<uint16_t>(std::rotl(folded, 8));
+    else
+        return folded;
+}
+
+// ones' complement sum of bytes at an odd (or even) position from the start of the checksummed data
+inline uint16_t sum_at(const std::byte* data, size_t n, bool odd) noexcept
+{
+    const auto s = sum(data, n);
+    return odd ? static_cast<uint16_t>(std::rotl(s, 8)) : s;
+}
+
+}  // namespace detail_checksum
+
+constexpr uint16_t ones_complement_add(uint16_t a, uint16_t b) noexcept
+{
+    const uint32_t s = uint32_t{ a } + b;
+    return static_cast<uint16_t>((s & 0xFFFF) + (s >> 16));
+}
+
+// ones' complement sum of the data, not complemented
+inline uint16_t ones_complement_sum(std::span<const std::byte> data, uint16_t initial = 0) noexcept
+{
+    return ones_complement_add(initial, detail_checksum::sum(data.data(), data.size()));
+}
+
+// checksum of the data, initial being the sum of what precedes it (e.g. a pseudo-header)
+inline uint16_t internet_checksum(std::span<const std::byte> data, uint16_t initial = 0) noexcept
+{
+    return static_cast<uint16_t>(~ones_complement_sum(data, initial));
+}
+
+// true if data including its checksum sums to 0xFFFF (or 0)
+inline bool verify_checksum(std::span<const std::byte> data, uint16_t initial = 0) noexcept
+{
+    const auto s = ones_complement_sum(data, initial);
+    return s == 0xFFFF || s == 0;
+}
+
+// checksum once the bytes old_bytes became new_bytes (same size), odd if they start at an
+// odd position of the checksummed data (RFC 1624: HC' = ~(~HC + ~m + m'))
+inline uint16_t update_checksum(uint16_t checksum, std::span<const std::byte> old_bytes, std::span<const std::byte> new_bytes, bool odd = false) noexcept
+{
+    auto s = ones_complement_add(static_cast<uint16_t>(~checksum), static_cast<uint16_t>(~detail_checksum::sum_at(old_bytes.data(), old_bytes.size(), odd)));
+    s = ones_complement_add(s, detail_checksum::sum_at(new_bytes.data(), new_bytes.size(), odd));
+    return static_cast<uint16_t>(~s);
+}
+
+// checksum once a 16-bit word of the data went from old_word to new_word
+constexpr uint16_t update_checksum(uint16_t checksum, uint16_t old_word, uint16_t new_word) noexcept
+{
+    return static_cast<uint16_t>(~ones_complement_add(ones_complement_add(static_cast<uint16_t>(~checksum), static_cast<uint16_t>(~old_word)), new_word));
+}
+
+// field (an EndianWrapper or a BitPack) = value, and checksum updated accordingly. The
+// checksum is at an even position of the data it covers (as in IPv4, UDP and TCP headers),
+// and the field is part of that data or of a pseudo-header (the position of the field is
+// deduced from their addresses).
+template<typename W, endian_wrapper C>
+requires (endian_wrapper<W> || bit_pack<W>) && std::is_same_v<typename C::value_type, uint16_t>
+inline void set_checksummed(W& field, typename W::value_type value, C& checksum) noexcept
+{
+    std::byte old_bytes[sizeof(W)];
+    std::memcpy(old_bytes, &field, sizeof(W));
+    field = value;
+    const bool odd = ((reinterpret_cast<uintptr_t>(&field) - reinterpret_cast<uintptr_t>(&checksum)) & 1) != 0;
+    checksum = update_checksum(checksum(), old_bytes, std::span<const std::byte>(reinterpret_cast<const std::byte*>(&field), sizeof(W)), odd);
+}
+
+// set_checksummed() for a UDP checksum: the field is only assigned if the checksum is 0 (no
+// checksum), and an updated checksum of 0 becomes 0xFFFF (its other ones' complement zero)
+template<typename W, endian_wrapper C>
+requires (endian_wrapper<W> || bit_pack<W>) && std::is_same_v<typename C::value_type, uint16_t>
+inline void set_udp_checksummed(W& field, typename W::value_type value, C& checksum) noexcept
+{
+    if (checksum() == 0)
+    {
+        field = value;
+        return;
+    }
+    set_checksummed(field, value, checksum);
+    if (checksum() == 0)
+        checksum = uint16_t{ 0xFFFF };
+}
+
+}  // namespace openmsg
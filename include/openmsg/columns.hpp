@@ -0,0 +1,412 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/bulk.hpp"
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/reflection.hpp"
+#include "openmsg/type_traits.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace openmsg {
+
+// Columnar (structure of arrays) copy of a batch of messages: one contiguous column of
+// host values per field of a reflectable message (see reflection.hpp), with a null
+// bitmap for optional fields (values equal to their nullValue):
+//
+//     Columns<Msg> columns;
+//     transpose(std::span<const Msg>(msgs), columns);
+//     auto prices = columns.column<"price">().values();  // std::span of host values
+//     bool missing = columns.column<"price">().is_null(i);
+//
+// An array member gives extent values per message. A composite member (reflectable, e.g.
+// a Decimal) has the columns of its own members, transposed the same way:
+//
+//     auto mantissas = columns.column<"price">().column<"mantissa">().values();
+//
+// Other members than EndianWrapper (e.g. ArrayChar) are copied as they are. Arrays of
+// composites are not supported.
+//
+// The batch is transposed in blocks of messages which fit in the L1 cache: for each
+// field, the wire values are gathered into the column, then byte swapped in place with
+// the bulk (SIMD) kernels.
+//
+// interleave() is the reverse, from Columns<Msg> or from one span of host values per
+// field (composites being given as they are), each field of a block is byte swapped into
+// a scratch buffer then scattered into the messages (bytes not covered by a field, e.g.
+// padding, are left as they are). Null values of optional fields are written as their
+// nullValue.
+
+constexpr size_t columns_block_bytes = 16 * 1024;
+
+namespace detail_columns {
+
+template<typename T>
+constexpr bool is_optional() noexcept
+{
+    if constexpr (endian_wrapper<T>)
+        return T::is_optional;
+    else
+        return false;
+}
+
+// wire values which can be gathered into a column of host values, then converted in place
+template<typename T>
+constexpr bool is_gathered() noexcept
+{
+    if constexpr (endian_wrapper<T>)
+        return sizeof(T) == sizeof(typename T::value_type);
+    else
+        return true;
+}
+
+template<typename Field>
+constexpr bool is_composite() noexcept
+{
+    return !Field::is_wrapper && reflectable<typename Field::element_type>;
+}
+
+}  // namespace detail_columns
+
+template<reflectable Msg> class Columns;
+
+template<typename Field>
+class Column
+{
+public:
+    using field_type = Field;
+    using element_type = typename Field::element_type;
+    using value_type = std::conditional_t<Field::is_wrapper, typename Field::value_type, element_type>;
+    constexpr static size_t extent = Field::extent;  // values per message
+    constexpr static bool is_optional = detail_columns::is_optional<element_type>();
+
+    size_t size() const noexcept { return m_values.size(); }
+
+    std::span<value_type> values() noexcept { return m_values; }
+    std::span<const value_type> values() const noexcept { return m_values; }
+
+    // values of the i-th message
+    std::span<value_type, extent> values(size_t i) noexcept { return std::span<value_type, extent>(m_values.data() + i * extent, extent); }
+    std::span<const value_type, extent> values(size_t i) const noexcept { return std::span<const value_type, extent>(m_values.data() + i * extent, extent); }
+
+    // null bitmap, bit k of word k / 64 for the k-th value (empty if the field is not optional)
+    std::span<uint64_t> nulls() noexcept { return m_nulls; }
+    std::span<const uint64_t> nulls() const noexcept { return m_nulls; }
+
+    bool is_null(size_t k) const noexcept
+    {
+        if constexpr (is_optional)
+            return (m_nulls[k / 64] >> (k % 64)) & 1;
+        else
+            return false;
+    }
+
+    void set_null(size_t k, bool null) noexcept
+    {
+        if constexpr (is_optional)
+            m_nulls[k / 64] = (m_nulls[k / 64] & ~(uint64_t{ 1 } << (k % 64))) | (static_cast<uint64_t>(null) << (k % 64));
+    }
+
+    void resize(size_t messages)
+    {
+        m_values.resize(messages * extent);
+        if constexpr (is_optional)
+            m_nulls.resize((messages * extent + 63) / 64);
+    }
+
+private:
+    std::vector<value_type> m_values;
+    std::vector<uint64_t> m_nulls;
+};
+
+// composite member, a column per member of the composite
+template<typename Field>
+requires (detail_columns::is_composite<Field>())
+class Column<Field>
+{
+public:
+    static_assert(!Field::is_array, "arrays of composites are not supported");
+
+    using field_type = Field;
+    using element_type = typename Field::element_type;
+    using value_type = element_type;  // given as it is to interleave() from spans
+    constexpr static size_t extent = 1;
+    constexpr static bool is_optional = false;
+
+    size_t size() const noexcept { return m_columns.size(); }
+
+    Columns<element_type>& columns() noexcept { return m_columns; }
+    const Columns<element_type>& columns() const noexcept { return m_columns; }
+
+    template<size_t I> auto& column() noexcept { return m_columns.template column<I>(); }
+    template<size_t I> const auto& column() const noexcept { return m_columns.template column<I>(); }
+
+    template<fixed_string Name> auto& column() noexcept { return m_columns.template column<Name>(); }
+    template<fixed_string Name> const auto& column() const noexcept { return m_columns.template column<Name>(); }
+
+    void resize(size_t messages) { m_columns.resize(messages); }
+
+private:
+    Columns<element_type> m_columns;
+};
+
+namespace detail_columns {
+
+// f(first, last) for blocks of messages fitting in columns_block_bytes
+template<typename Msg, typename F>
+inline void for_each_block(size_t n, F&& f)
+{
+    constexpr size_t block = std::max<size_t>(1, columns_block_bytes / sizeof(Msg));
+    for (size_t first = 0; first < n; first += block)
+        f(first, std::min(first + block, n));
+}
+
+template<typename List> struct columns_base;
+template<typename... Fields> struct columns_base<FieldList<Fields...>> : Column<Fields>...
+{
+    void resize_columns(size_t messages)
+    {
+        (Column<Fields>::resize(messages), ...);
+    }
+};
+
+// wire values of a field of count records (src, stride bytes apart, e.g. messages) gathered
+// into its column from the first-th record, then converted to host values
+template<typename Field>
+inline void transpose_field(const std::byte* src, size_t stride, size_t count, size_t first, Column<Field>& column) noexcept
+{
+    using E = typename Field::element_type;
+    constexpr size_t extent = Field::extent;
+    src += Field::offset;
+    if constexpr (is_composite<Field>())
+    {
+        for_each_field<E>([&](auto field)
+        {
+            using F = decltype(field);
+            transpose_field<F>(src, stride, count, first, static_cast<Column<F>&>(column.columns()));
+        });
+        return;
+    }
+    else
+    {
+        auto values = column.values().subspan(first * extent, count * extent);
+        if constexpr (is_gathered<E>())
+        {
+            auto dst = reinterpret_cast<std::byte*>(values.data());
+            for (size_t i = 0; i < count; ++i, src += stride, dst += Field::size)
+                std::memcpy(dst, src, Field::size);
+            if constexpr (Field::is_wrapper)
+                mtoh<E>(values);
+        }
+        else
+        {
+            for (size_t k = 0; k < values.size(); ++k)
+            {
+                E element;
+                std::memcpy(&element, src + (k / extent) * stride + (k % extent) * sizeof(E), sizeof(E));
+                values[k] = element();
+            }
+        }
+        if constexpr (Column<Field>::is_optional)
+        {
+            using U = as_uint_type_t<typename Field::value_type>;
+            constexpr auto null = std::bit_cast<U>(E::nullValue);
+            for (size_t k = 0; k < values.size(); ++k)
+                column.set_null(first * extent + k, std::bit_cast<U>(values[k]) == null);
+        }
+    }
+}
+
+}  // namespace detail_columns
+
+template<reflectable Msg>
+class Columns : public detail_columns::columns_base<fields_t<Msg>>
+{
+public:
+    using message_type = Msg;
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    void resize(size_t messages)
+    {
+        this->resize_columns(messages);
+        m_size = messages;
+    }
+
+    template<size_t I> Column<field_t<Msg, I>>& column() noexcept { return *this; }
+    template<size_t I> const Column<field_t<Msg, I>>& column() const noexcept { return *this; }
+
+    template<fixed_string Name>
+    requires (field_index<Msg>(Name.view()) < field_count<Msg>)
+    auto& column() noexcept { return column<field_index<Msg>(Name.view())>(); }
+
+    template<fixed_string Name>
+    requires (field_index<Msg>(Name.view()) < field_count<Msg>)
+    const auto& column() const noexcept { return column<field_index<Msg>(Name.view())>(); }
+
+private:
+    size_t m_size = 0;
+};
+
+// AoS to SoA, columns are resized to the number of messages
+
+template<reflectable Msg>
+inline void transpose(std::span<const Msg> msgs, Columns<Msg>& columns)
+{
+    columns.resize(msgs.size());
+    detail_columns::for_each_block<Msg>(msgs.size(), [&](size_t first, size_t last)
+    {
+        for_each_field<Msg>([&](auto field)
+        {
+            using F = decltype(field);
+            detail_columns::transpose_field<F>(reinterpret_cast<const std::byte*>(msgs.data() + first), sizeof(Msg), last - first, first, static_cast<Column<F>&>(columns));
+        });
+    });
+}
+
+template<reflectable Msg>
+inline Columns<Msg> transpose(std::span<const Msg> msgs)
+{
+    Columns<Msg> columns;
+    transpose(msgs, columns);
+    return columns;
+}
+
+namespace detail_columns {
+
+// host values of a field of records [first, first + records) converted into a scratch
+// buffer, then scattered into the records (dst, stride bytes apart, e.g. messages), nulls is
+// the null bitmap of the field's column (or nullptr)
+template<typename Field>
+inline void interleave_field(std::span<const typename Column<Field>::value_type> values, const uint64_t* nulls, size_t first, size_t records, std::byte* dst, size_t stride) noexcept
+{
+    using E = typename Field::element_type;
+    using T = typename Column<Field>::value_type;
+    constexpr size_t extent = Field::extent;
+    const auto count = records * extent;
+    auto src = values.subspan(first * extent, count);
+    dst += Field::offset;
+    if constexpr (detail_columns::is_gathered<E>())
+    {
+        static_assert(Field::size <= columns_block_bytes);
+        alignas(64) std::byte scratch[columns_block_bytes];
+        bool with_nulls = false;
+        if constexpr (Column<Field>::is_optional)
+            with_nulls = nulls != nullptr;
+        if (!with_nulls)
+            std::memcpy(scratch, src.data(), count * sizeof(T));
+        else if constexpr (Column<Field>::is_optional)
+        {
+            for (size_t k = 0; k < count; ++k)
+            {
+                const auto i = first * extent + k;
+                const T value = ((nulls[i / 64] >> (i % 64)) & 1) ? E::nullValue : src[k];
+                std::memcpy(scratch + k * sizeof(T), &value, sizeof(T));
+            }
+        }
+        if constexpr (Field::is_wrapper)
+        {
+            if constexpr (detail_bulk::is_bulk<E>)
+                detail_bulk::convert<E>(scratch, scratch, count);
+            else
+                for (size_t k = 0; k < count; ++k)
+                {
+                    T value;
+                    std::memcpy(&value, scratch + k * sizeof(T), sizeof(T));
+                    const E wire(value);
+                    std::memcpy(scratch + k * sizeof(T), &wire, sizeof(E));
+                }
+        }
+        const std::byte* from = scratch;
+        for (size_t i = 0; i < records; ++i, from += Field::size, dst += stride)
+            std::memcpy(dst, from, Field::size);
+    }
+    else
+    {
+        for (size_t k = 0; k < count; ++k)
+        {
+            const auto i = first * extent + k;
+            const bool null = Column<Field>::is_optional && nulls != nullptr && ((nulls[i / 64] >> (i % 64)) & 1);
+            const E wire(null ? E::nullValue : src[k]);
+            std::memcpy(dst + (k / extent) * stride + (k % extent) * sizeof(E), &wire, sizeof(E));
+        }
+    }
+}
+
+// a field from its column, members of composites from their own columns
+template<typename Field>
+inline void interleave_column(const Column<Field>& column, size_t first, size_t records, std::byte* dst, size_t stride) noexcept
+{
+    if constexpr (is_composite<Field>())
+    {
+        for_each_field<typename Field::element_type>([&](auto field)
+        {
+            using F = decltype(field);
+            interleave_column<F>(static_cast<const Column<F>&>(column.columns()), first, records, dst + Field::offset, stride);
+        });
+    }
+    else
+        interleave_field<Field>(column.values(), column.nulls().empty() ? nullptr : column.nulls().data(), first, records, dst, stride);
+}
+
+template<typename... Fields, typename Msg, typename... Values>
+inline size_t interleave(FieldList<Fields...>, std::span<Msg> msgs, std::span<const Values>... values) noexcept
+{
+    const auto n = std::min({ msgs.size(), (values.size() / Fields::extent)... });
+    for_each_block<Msg>(n, [&](size_t first, size_t last)
+    {
+        (interleave_field<Fields>(values, nullptr, first, last - first, reinterpret_cast<std::byte*>(msgs.data() + first), sizeof(Msg)), ...);
+    });
+    return n;
+}
+
+}  // namespace detail_columns
+
+// SoA to AoS, returns the number of messages written (up to the smaller of the sizes)
+
+template<reflectable Msg>
+inline size_t interleave(const Columns<Msg>& columns, std::span<Msg> msgs) noexcept
+{
+    const auto n = std::min(columns.size(), msgs.size());
+    detail_columns::for_each_block<Msg>(n, [&](size_t first, size_t last)
+    {
+        for_each_field<Msg>([&](auto field)
+        {
+            using F = decltype(field);
+            detail_columns::interleave_column<F>(static_cast<const Column<F>&>(columns), first, last - first, reinterpret_cast<std::byte*>(msgs.data() + first), sizeof(Msg));
+        });
+    });
+    return n;
+}
+
+// one span of host values per field, in declaration order (extent values per message for
+// arrays), the values of missing optional entries being their nullValue
+template<reflectable Msg, typename... Values>
+requires (sizeof...(Values) == field_count<Msg>)
+inline size_t interleave(std::span<Msg> msgs, std::span<const Values>... values) noexcept
+{
+    return detail_columns::interleave(fields_t<Msg>{}, msgs, values...);
+}
+
+}  // namespace openmsg
@@ -0,0 +1,371 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/bounds.hpp"
+#include "openmsg/bulk.hpp"
+#include "openmsg/concepts.hpp"
+#include "openmsg/endian_wrapper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <inttypes.h>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace openmsg {
+
+// Decimal composites (SBE decimal, e.g. prices): value = mantissa * 10^exponent, with a
+// constant exponent or one sent with the mantissa:
+//
+//     Decimal<BigEndian<Optionull<int64_t>>, ConstantExponent<-4>> price;  // 8 bytes
+//     Decimal<le_int64_t, LittleEndian<int8_t>> amount;                    // 9 bytes
+//
+//     int64_t ticks;
+//     if (price.to_scaled(-2, ticks))   // price in hundredths (truncated), false if null
+//         ...
+//     if (price < amount)               // exact, whatever the exponents
+//         ...
+//
+// The functions below (to_scaled, to_double, compare_decimals, and their batch forms)
+// take any composite with a signed integral EndianWrapper mantissa member (as SBE decimals,
+// handled as int64_t: unsigned mantissas are rejected), and an exponent which is either a
+// static constant or an EndianWrapper member, e.g. the composites generated by sbe_codegen. A decimal is null if its mantissa is optional (Optionull) and
+// holds its nullValue. Conversions use tables of powers of ten, there is no floating
+// point (but in to_double()).
+
+template<int8_t Exponent>
+struct ConstantExponent
+{
+    constexpr static int8_t value = Exponent;
+};
+
+namespace detail_decimal {
+
+template<typename T>
+constexpr bool is_integral_wrapper() noexcept
+{
+    if constexpr (endian_wrapper<T>)
+        return any_integral<typename T::value_type>;
+    else
+        return false;
+}
+
+// mantissas are handled as int64_t, as SBE decimals (an uint64_t would not fit)
+template<typename T>
+constexpr bool is_mantissa_wrapper() noexcept
+{
+    if constexpr (endian_wrapper<T>)
+        return signed_integral<typename T::value_type>;
+    else
+        return false;
+}
+
+}  // namespace detail_decimal
+
+namespace detail_decimal {
+
+template<typename T>
+constexpr bool has_exponent() noexcept
+{
+    if constexpr (!requires { T::exponent; })
+        return false;
+    else if constexpr (std::is_member_object_pointer_v<decltype(&T::exponent)>)
+        return is_integral_wrapper<std::remove_cvref_t<decltype(std::declval<const T&>().exponent)>>();
+    else
+        return std::is_integral_v<std::remove_cvref_t<decltype(T::exponent)>>;
+}
+
+}  // namespace detail_decimal
+
+template<typename T> concept decimal = requires(const T& d)
+{
+    requires detail_decimal::is_mantissa_wrapper<std::remove_cvref_t<decltype(d.mantissa)>>();
+    requires detail_decimal::has_exponent<T>();
+};
+
+template<decimal D> constexpr bool has_constant_exponent = !std::is_member_object_pointer_v<decltype(&D::exponent)>;
+
+namespace detail_decimal {
+
+constexpr std::array<int64_t, 19> powers_of_ten = []()
+{
+    std::array<int64_t, 19> powers = {};
+    powers[0] = 1;
+    for (size_t i = 1; i < powers.size(); ++i)
+        powers[i] = powers[i - 1] * 10;
+    return powers;
+}();
+
+constexpr std::array<double, 23> double_powers_of_ten = []()  // exact up to 10^22
+{
+    std::array<double, 23> powers = {};
+    powers[0] = 1;
+    for (size_t i = 1; i < powers.size(); ++i)
+        powers[i] = powers[i - 1] * 10;
+    return powers;
+}();
+
+template<decimal D>
+constexpr int exponent_of(const D& d) noexcept
+{
+    if constexpr (has_constant_exponent<D>)
+        return D::exponent;
+    else
+        return d.exponent();
+}
+
+template<decimal D>
+constexpr bool is_null(const D& d) noexcept
+{
+    using M = std::remove_cvref_t<decltype(d.mantissa)>;
+    if constexpr (M::is_optional)
+        return d.mantissa() == M::nullValue;
+    else
+        return false;
+}
+
+// mantissa * 10^shift, false if it does not fit in an int64_t (truncated toward zero if shift < 0)
+constexpr bool scale(int64_t mantissa, int shift, int64_t& scaled) noexcept
+{
+    if (shift < 0)
+    {
+        scaled = -shift < static_cast<int>(powers_of_ten.size()) ? mantissa / powers_of_ten[static_cast<size_t>(-shift)] : 0;
+        return true;
+    }
+    if (shift >= static_cast<int>(powers_of_ten.size()))
+    {
+        scaled = 0;
+        return mantissa == 0;
+    }
+    const auto factor = powers_of_ten[static_cast<size_t>(shift)];
+    const auto limit = std::numeric_limits<int64_t>::max() / factor;
+    scaled = static_cast<int64_t>(static_cast<uint64_t>(mantissa) * static_cast<uint64_t>(factor));  // no signed overflow
+    return -limit <= mantissa && mantissa <= limit;
+}
+
+constexpr std::strong_ordering compare(int64_t ma, int ea, int64_t mb, int eb) noexcept
+{
+    if (ea < eb)
+        return 0 <=> compare(mb, eb, ma, ea);
+    int64_t scaled;
+    if (!scale(ma, ea - eb, scaled))
+        return ma < 0 ? std::strong_ordering::less : std::strong_ordering::greater;  // beyond any int64_t
+    return scaled <=> mb;
+}
+
+constexpr double to_double(int64_t mantissa, int exponent) noexcept
+{
+    auto value = static_cast<double>(mantissa);
+    for (; exponent > 22; exponent -= 22)
+        value *= double_powers_of_ten[22];
+    for (; exponent < -22; exponent += 22)
+        value /= double_powers_of_ten[22];
+    return exponent >= 0 ? value * double_powers_of_ten[static_cast<size_t>(exponent)] : value / double_powers_of_ten[static_cast<size_t>(-exponent)];
+}
+
+}  // namespace detail_decimal
+
+// null (its mantissa is optional and holds its nullValue)
+template<decimal D>
+constexpr bool is_null(const D& d) noexcept
+{
+    return detail_decimal::is_null(d);
+}
+
+// value in units of 10^target_exponent (e.g. ticks), truncated toward zero, false if null or
+// if it does not fit in an int64_t
+template<decimal D>
+constexpr bool to_scaled(const D& d, int target_exponent, int64_t& scaled) noexcept
+{
+    if (detail_decimal::is_null(d))
+        return false;
+    return detail_decimal::scale(static_cast<int64_t>(d.mantissa()), detail_decimal::exponent_of(d) - target_exponent, scaled);
+}
+
+// value, NaN if null
+template<decimal D>
+constexpr double to_double(const D& d) noexcept
+{
+    if (detail_decimal::is_null(d))
+        return std::numeric_limits<double>::quiet_NaN();
+    return detail_decimal::to_double(static_cast<int64_t>(d.mantissa()), detail_decimal::exponent_of(d));
+}
+
+// d = value * 10^exponent, rescaled (truncated toward zero) if the exponent of d is constant,
+// false if it does not fit in the mantissa (or the exponent) of d, which is then left as it is
+template<decimal D>
+constexpr bool from_scaled(D& d, int64_t value, int exponent) noexcept
+{
+    using M = std::remove_cvref_t<decltype(d.mantissa)>;
+    using T = typename M::value_type;
+    int64_t mantissa = value;
+    if constexpr (has_constant_exponent<D>)
+    {
+        if (!detail_decimal::scale(value, exponent - D::exponent, mantissa))
+            return false;
+    }
+    else
+    {
+        using E = typename std::remove_cvref_t<decltype(d.exponent)>::value_type;
+        if (exponent < std::numeric_limits<E>::min() || exponent > std::numeric_limits<E>::max())
+            return false;
+    }
+    if (mantissa < std::numeric_limits<T>::min() || mantissa > std::numeric_limits<T>::max() || (M::is_optional && mantissa == M::nullValue))
+        return false;
+    d.mantissa = static_cast<T>(mantissa);
+    if constexpr (!has_constant_exponent<D>)
+        d.exponent = static_cast<typename std::remove_cvref_t<decltype(d.exponent)>::value_type>(exponent);
+    return true;
+}
+
+// exact comparison, whatever the exponents, unordered if either is null
+template<decimal A, decimal B>
+constexpr std::partial_ordering compare_decimals(const A& a, const B& b) noexcept
+{
+    if (detail_decimal::is_null(a) || detail_decimal::is_null(b))
+        return std::partial_ordering::unordered;
+    return detail_decimal::compare(static_cast<int64_t>(a.mantissa()), detail_decimal::exponent_of(a), static_cast<int64_t>(b.mantissa()), detail_decimal::exponent_of(b));
+}
+
+// batch conversions, up to the smaller of the sizes, return the number of converted values
+
+// values in units of 10^target_exponent, null_scaled for nulls and values which do not fit in
+// an int64_t (which are not counted). With a constant exponent, the mantissas are converted
+// with the bulk (SIMD) kernels, then scaled by a constant factor.
+template<decimal D>
+inline size_t to_scaled(std::span<const D> decimals, std::span<int64_t> scaled, int target_exponent, int64_t null_scaled = bounds<int64_t>::nullValue) noexcept
+{
+    using M = std::remove_cvref_t<decltype(std::declval<const D&>().mantissa)>;
+    using T = typename M::value_type;
+    const auto n = std::min(decimals.size(), scaled.size());
+    size_t converted = 0;
+    if constexpr (has_constant_exponent<D> && sizeof(D) == sizeof(M))
+    {
+        constexpr size_t block = 256;
+        T mantissas[block];
+        const int shift = D::exponent - target_exponent;
+        for (size_t first = 0; first < n; first += block)
+        {
+            const auto count = std::min(block, n - first);
+            mtoh(std::span<const M>(&decimals[first].mantissa, count), std::span<T>(mantissas, count));
+            for (size_t k = 0; k < count; ++k)
+            {
+                int64_t value;
+                bool valid = detail_decimal::scale(static_cast<int64_t>(mantissas[k]), shift, value);
+                if constexpr (M::is_optional)
+                    valid &= mantissas[k] != M::nullValue;
+                scaled[first + k] = valid ? value : null_scaled;
+                converted += valid;
+            }
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            int64_t value;
+            const bool valid = to_scaled(decimals[i], target_exponent, value);
+            scaled[i] = valid ? value : null_scaled;
+            converted += valid;
+        }
+    }
+    return converted;
+}
+
+// values, NaN for nulls (which are not counted)
+template<decimal D>
+inline size_t to_double(std::span<const D> decimals, std::span<double> values) noexcept
+{
+    const auto n = std::min(decimals.size(), values.size());
+    size_t converted = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        values[i] = to_double(decimals[i]);
+        converted += !detail_decimal::is_null(decimals[i]);
+    }
+    return converted;
+}
+
+// decimals[i] = scaled[i] * 10^exponent, values which do not fit are set to null if the
+// mantissa is optional (and are not counted)
+template<decimal D>
+inline size_t from_scaled(std::span<const int64_t> scaled, int exponent, std::span<D> decimals) noexcept
+{
+    using M = std::remove_cvref_t<decltype(std::declval<D&>().mantissa)>;
+    const auto n = std::min(decimals.size(), scaled.size());
+    size_t converted = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const bool valid = from_scaled(decimals[i], scaled[i], exponent);
+        if constexpr (M::is_optional)
+            if (!valid)
+                decimals[i].mantissa = M::nullValue;
+        converted += valid;
+    }
+    return converted;
+}
+
+// Decimal composites
+
+#pragma pack(push, 1)
+
+template<endian_wrapper Mantissa, typename Exponent>
+requires signed_integral<typename Mantissa::value_type>
+struct Decimal;
+
+template<endian_wrapper Mantissa, int8_t E>
+requires signed_integral<typename Mantissa::value_type>
+struct Decimal<Mantissa, ConstantExponent<E>>
+{
+    Mantissa mantissa;
+    constexpr static int8_t exponent = E;
+
+    constexpr bool is_null() const noexcept { return openmsg::is_null(*this); }
+    constexpr bool to_scaled(int target_exponent, int64_t& scaled) const noexcept { return openmsg::to_scaled(*this, target_exponent, scaled); }
+    constexpr double to_double() const noexcept { return openmsg::to_double(*this); }
+    constexpr bool from_scaled(int64_t value, int value_exponent) noexcept { return openmsg::from_scaled(*this, value, value_exponent); }
+
+    template<decimal D>
+    constexpr std::partial_ordering operator<=>(const D& rhs) const noexcept { return compare_decimals(*this, rhs); }
+
+    template<decimal D>
+    constexpr bool operator==(const D& rhs) const noexcept { return compare_decimals(*this, rhs) == 0; }
+};
+
+template<endian_wrapper Mantissa, endian_wrapper Exponent>
+requires signed_integral<typename Mantissa::value_type> && signed_integral<typename Exponent::value_type>
+struct Decimal<Mantissa, Exponent>
+{
+    Mantissa mantissa;
+    Exponent exponent;
+
+    constexpr bool is_null() const noexcept { return openmsg::is_null(*this); }
+    constexpr bool to_scaled(int target_exponent, int64_t& scaled) const noexcept { return openmsg::to_scaled(*this, target_exponent, scaled); }
+    constexpr double to_double() const noexcept { return openmsg::to_double(*this); }
+    constexpr bool from_scaled(int64_t value, int value_exponent) noexcept { return openmsg::from_scaled(*this, value, value_exponent); }
+
+    template<decimal D>
+    constexpr std::partial_ordering operator<=>(const D& rhs) const noexcept { return compare_decimals(*this, rhs); }
+
+    template<decimal D>
+    constexpr bool operator==(const D& rhs) const noexcept { return compare_decimals(*this, rhs) == 0; }
+};
+
+#pragma pack(pop)
+
+}  // namespace openmsg
@@ -0,0 +1,164 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/bulk.hpp"
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/type.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace openmsg {
+
+// Host-native mirror of a message: each EndianWrapper member is decoded once into a
+// naturally aligned Type (which keeps the attributes, e.g. of Optionull), instead of
+// being byte swapped on every access.
+//
+// A message declares its mirror as a nested decoded_type, whose members are the host_t
+// of the message's members, with static decode() and encode() converting the members
+// (this is what sbe_codegen generates):
+//
+//     struct Msg
+//     {
+//         BigEndian<uint32_t> a;
+//         BigEndian<Optionull<int16_t>> b[4];
+//         struct decoded_type;
+//     };
+//
+//     struct Msg::decoded_type
+//     {
+//         host_t<decltype(Msg::a)> a;
+//         host_t<decltype(Msg::b)> b;
+//
+//         static void decode(const Msg& src, decoded_type& dst) noexcept
+//         {
+//             decode_member(src.a, dst.a);
+//             decode_member(src.b, dst.b);
+//         }
+//         static void encode(const decoded_type& src, Msg& dst) noexcept { ... encode_member() ... }
+//     };
+//
+//     auto d = decode(msg);  // Decoded<Msg>
+//     encode(d, msg);
+
+template<typename T> concept decodable = requires { typename T::decoded_type; };
+
+template<decodable Msg> using Decoded = typename Msg::decoded_type;
+
+namespace detail_decoded {
+
+template<typename T> struct host { using type = T; };  // e.g. ArrayChar
+
+template<endian_wrapper W> struct host<W>
+{
+    using type = Type<typename W::value_type, typename W::attributes>;
+};
+
+template<decodable T> struct host<T>
+{
+    using type = Decoded<T>;
+};
+
+template<typename T, size_t N> struct host<T[N]>
+{
+    using type = typename host<T>::type[N];
+};
+
+}  // namespace detail_decoded
+
+// host type of a message member
+template<typename T> using host_t = typename detail_decoded::host<T>::type;
+
+namespace detail_decoded {
+
+// arrays whose wrappers can be converted with the bulk kernels, in place of the host array
+template<typename E>
+constexpr bool is_bulk_array_element() noexcept
+{
+    if constexpr (endian_wrapper<E>)
+        return detail_bulk::is_bulk<E> && sizeof(host_t<E>) == sizeof(E);
+    else
+        return false;
+}
+
+}  // namespace detail_decoded
+
+// member conversions, arrays of wrappers are converted with the bulk (SIMD) kernels
+
+template<typename T>
+inline void decode_member(const T& src, host_t<T>& dst) noexcept
+{
+    if constexpr (endian_wrapper<T>)
+        dst = src();
+    else if constexpr (decodable<T>)
+        Decoded<T>::decode(src, dst);
+    else if constexpr (std::is_array_v<T>)
+    {
+        using E = std::remove_extent_t<T>;
+        if constexpr (detail_decoded::is_bulk_array_element<E>())
+            detail_bulk::convert<E>(reinterpret_cast<const std::byte*>(&src), reinterpret_cast<std::byte*>(&dst), std::extent_v<T>);
+        else
+            for (size_t i = 0; i < std::extent_v<T>; ++i)
+                decode_member(src[i], dst[i]);
+    }
+    else
+        dst = src;
+}
+
+template<typename T>
+inline void encode_member(const host_t<T>& src, T& dst) noexcept
+{
+    if constexpr (endian_wrapper<T>)
+        dst = src();
+    else if constexpr (decodable<T>)
+        Decoded<T>::encode(src, dst);
+    else if constexpr (std::is_array_v<T>)
+    {
+        using E = std::remove_extent_t<T>;
+        if constexpr (detail_decoded::is_bulk_array_element<E>())
+            detail_bulk::convert<E>(reinterpret_cast<const std::byte*>(&src), reinterpret_cast<std::byte*>(&dst), std::extent_v<T>);
+        else
+            for (size_t i = 0; i < std::extent_v<T>; ++i)
+                encode_member(src[i], dst[i]);
+    }
+    else
+        dst = src;
+}
+
+// whole message conversions
+
+template<decodable Msg>
+inline Decoded<Msg> decode(const Msg& msg) noexcept
+{
+    Decoded<Msg> decoded;
+    Decoded<Msg>::decode(msg, decoded);
+    return decoded;
+}
+
+template<decodable Msg>
+inline void encode(const Decoded<Msg>& decoded, Msg& msg) noexcept
+{
+    Decoded<Msg>::encode(decoded, msg);
+}
+
+template<decodable Msg>
+inline Msg encode(const Decoded<Msg>& decoded) noexcept
+{
+    Msg msg;
+    Decoded<Msg>::encode(decoded, msg);
+    return msg;
+}
+
+}  // namespace openmsg
@@ -0,0 +1,200 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/endian_wrapper.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+namespace openmsg {
+
+// Simple Binary Encoding (SBE) message header
+
+#pragma pack(push, 1)
+
+template<template<typename...> class _W = LittleEndian>
+struct MessageHeader
+{
+    _W<uint16_t> blockLength;
+    _W<uint16_t> templateId;
+    _W<uint16_t> schemaId;
+    _W<uint16_t> version;
+};
+
+#pragma pack(pop)
+
+template<typename T> concept message_header = requires(const T& a)
+{
+    requires std::is_trivially_copyable_v<T>;
+    { a.blockLength() } -> std::convertible_to<size_t>;
+    { a.templateId() } -> std::convertible_to<size_t>;
+};
+
+// messages provide their template id as a constant, e.g. constexpr static uint16_t templateId = 1;
+template<typename T> concept identified_message = requires
+{
+    requires std::is_trivially_copyable_v<T> && alignof(T) == 1;  // i.e. packed
+    { T::templateId } -> std::convertible_to<size_t>;
+};
+
+// Dispatcher calls a handler with the message matching the header's templateId.
+//
+// The templateId to message lookup is built at compile time: a dense table if the ids are
+// (nearly) contiguous, or a perfect hash otherwise. The order of Msgs is taken as their
+// frequency order: the first message is the hot one, checked before the lookup (and marked
+// [[likely]]), the order of the others does not matter. E.g. for a market data feed:
+//
+//     using Feed = Dispatcher<MessageHeader<>, OrderBookUpdate, Trade, Heartbeat, Snapshot>;
+//
+// The handler is called with (const Msg&, std::span<const std::byte> tail) if it can,
+// otherwise with (const Msg&), tail being what follows the message's blockLength (e.g.
+// groups and variable length data).
+
+template<message_header Header, identified_message... Msgs>
+requires (sizeof...(Msgs) > 0)
+class Dispatcher
+{
+    constexpr static size_t count = sizeof...(Msgs);
+    constexpr static std::array<uint32_t, count> ids = { static_cast<uint32_t>(Msgs::templateId)... };
+    constexpr static uint32_t min_id = *std::min_element(ids.begin(), ids.end());
+    constexpr static uint32_t max_id = *std::max_element(ids.begin(), ids.end());
+
+    constexpr static bool are_unique() noexcept
+    {
+        auto sorted = ids;
+        std::sort(sorted.begin(), sorted.end());
+        return std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end();
+    }
+    static_assert(are_unique(), "templateId must be unique");
+
+public:
+    constexpr static bool is_dense = max_id - min_id < 4 * count + 16;
+
+private:
+    // perfect hash: slot = (id * multiplier) >> shift
+    struct hash_parameters
+    {
+        uint32_t multiplier = 0;
+        unsigned shift = 0;
+        size_t size = 1;
+    };
+
+    constexpr static unsigned max_bits = std::bit_width(count) + 6;
+
+    constexpr static hash_parameters find_perfect_hash() noexcept
+    {
+        for (unsigned bits = std::max(1u, static_cast<unsigned>(std::bit_width(count - 1))); bits <= max_bits; ++bits)
+        {
+            for (uint32_t seed = 1; seed <= 4096; ++seed)
+            {
+                const auto multiplier = (seed * 0x9E3779B1u) | 1u;
+                const auto shift = 32u - bits;
+                std::array<bool, static_cast<size_t>(1) << max_bits> used = {};
+                bool collision = false;
+                for (auto id : ids)
+                {
+                    const auto slot = static_cast<uint32_t>(id * multiplier) >> shift;
+                    collision |= used[slot];
+                    used[slot] = true;
+                }
+                if (!collision)
+                    return { multiplier, shift, static_cast<size_t>(1) << bits };
+            }
+        }
+        return {};
+    }
+
+    constexpr static hash_parameters hash = is_dense ? hash_parameters{} : find_perfect_hash();
+    static_assert(is_dense || hash.multiplier != 0, "no perfect hash found for these templateId");
+
+    constexpr static size_t table_size = is_dense ? max_id - min_id + 1 : hash.size;
+
+    // index + 1 of the message, 0 being unknown
+    constexpr static std::array<uint16_t, table_size> make_table() noexcept
+    {
+        std::array<uint16_t, table_size> table = {};
+        for (size_t i = 0; i < count; ++i)
+            table[slot(ids[i])] = static_cast<uint16_t>(i + 1);
+        return table;
+    }
+
+    constexpr static size_t slot(uint32_t id) noexcept
+    {
+        if constexpr (is_dense)
+            return id - min_id;
+        else
+            return static_cast<uint32_t>(id * hash.multiplier) >> hash.shift;
+    }
+
+    constexpr static std::array<uint16_t, table_size> table = make_table();
+
+    template<typename Msg, typename Handler>
+    static bool invoke(const std::byte* body, size_t size, size_t block_length, Handler& handler)
+    {
+        if (block_length < sizeof(Msg) || size < block_length)
+            return false;
+        const auto& msg = *reinterpret_cast<const Msg*>(body);
+        if constexpr (std::is_invocable_v<Handler&, const Msg&, std::span<const std::byte>>)
+            handler(msg, std::span<const std::byte>(body + block_length, size - block_length));
+        else
+            handler(msg);
+        return true;
+    }
+
+    template<typename Handler>
+    using invoker = bool (*)(const std::byte*, size_t, size_t, Handler&);
+
+    template<typename Handler>
+    constexpr static invoker<Handler> invokers[count] = { &invoke<Msgs, Handler>... };
+
+    using first_message = std::tuple_element_t<0, std::tuple<Msgs...>>;
+
+public:
+    // returns false if the buffer is too small, or the templateId is unknown
+    template<typename Handler>
+    static bool dispatch(std::span<const std::byte> buffer, Handler&& handler)
+    {
+        if (buffer.size() < sizeof(Header))
+            return false;
+        Header header;
+        std::memcpy(&header, buffer.data(), sizeof(Header));
+        const auto id = static_cast<uint32_t>(header.templateId());
+        const auto body = buffer.data() + sizeof(Header);
+        const auto size = buffer.size() - sizeof(Header);
+        const size_t block_length = header.blockLength();
+
+        if (id == first_message::templateId) [[likely]]
+            return invoke<first_message>(body, size, block_length, handler);
+
+        if constexpr (is_dense)
+        {
+            if (id < min_id || id > max_id)
+                return false;
+        }
+        const auto index = table[slot(id)];
+        if (index == 0 || ids[index - 1u] != id)
+            return false;
+        return invokers<std::remove_reference_t<Handler>>[index - 1u](body, size, block_length, handler);
+    }
+};
+
+}  // namespace openmsg
@@ -108,6 +108,12 @@ private:
 
 #pragma pack(pop)
 
+template<typename T> struct is_endian_wrapper : std::false_type {};
+template<wrappable T, std::endian _endian, template<typename H, std::endian> class MemoryWrapper>
+struct is_endian_wrapper<EndianWrapper<T, _endian, MemoryWrapper>> : std::true_type {};
+
+template<typename T> concept endian_wrapper = is_endian_wrapper<T>::value;
+
 // BigEndian and LittleEndian
 template<wrappable T> using BigEndian    = EndianWrapper<T, std::endian::big>;
 template<wrappable T> using LittleEndian = EndianWrapper<T, std::endian::little>;
@@ -0,0 +1,263 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/endian_wrapper.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+#include <iterator>
+#include <span>
+#include <type_traits>
+
+namespace openmsg {
+
+// Simple Binary Encoding (SBE) repeating groups: a header (blockLength, numInGroup)
+// followed by numInGroup entries of blockLength bytes. blockLength may be larger
+// than sizeof(Entry) (e.g. entries from a newer schema version), the extra bytes
+// are skipped.
+
+#pragma pack(push, 1)
+
+template<template<typename...> class _W = LittleEndian>
+struct GroupSizeEncoding
+{
+    _W<uint16_t> blockLength;
+    _W<uint16_t> numInGroup;
+};
+
+#pragma pack(pop)
+
+template<typename T> concept group_header = requires(const T& a)
+{
+    requires std::is_trivially_copyable_v<T>;
+    { a.blockLength() } -> std::convertible_to<size_t>;
+    { a.numInGroup() } -> std::convertible_to<size_t>;
+};
+
+template<typename T> concept group_entry = std::is_trivially_copyable_v<T> && alignof(T) == 1;  // i.e. packed
+
+namespace detail_group {
+
+template<group_header Header>
+inline Header read_header(const std::byte* src) noexcept
+{
+    Header header;
+    std::memcpy(&header, src, sizeof(Header));
+    return header;
+}
+
+}  // namespace detail_group
+
+// Random access view over a group whose entries have a fixed size (i.e. no nested
+// groups or variable length data), entries are accessed in place.
+
+template<group_header Header, group_entry Entry>
+class GroupView
+{
+public:
+    using header_type = Header;
+    using entry_type = Entry;
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Entry*;
+        using reference = const Entry&;
+
+        constexpr iterator() noexcept = default;
+        constexpr iterator(const std::byte* entry, size_t block_length) noexcept
+            : m_entry(entry), m_block_length(static_cast<difference_type>(block_length))
+        {
+        }
+
+        reference operator*() const noexcept { return *reinterpret_cast<pointer>(m_entry); }
+        pointer operator->() const noexcept { return reinterpret_cast<pointer>(m_entry); }
+        reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+        constexpr iterator& operator++() noexcept { m_entry += m_block_length; return *this; }
+        constexpr iterator& operator--() noexcept { m_entry -= m_block_length; return *this; }
+        constexpr iterator operator++(int) noexcept { auto it = *this; ++*this; return it; }
+        constexpr iterator operator--(int) noexcept { auto it = *this; --*this; return it; }
+        constexpr iterator& operator+=(difference_type n) noexcept { m_entry += n * m_block_length; return *this; }
+        constexpr iterator& operator-=(difference_type n) noexcept { m_entry -= n * m_block_length; return *this; }
+        constexpr friend iterator operator+(iterator it, difference_type n) noexcept { return it += n; }
+        constexpr friend iterator operator+(difference_type n, iterator it) noexcept { return it += n; }
+        constexpr friend iterator operator-(iterator it, difference_type n) noexcept { return it -= n; }
+        constexpr friend difference_type operator-(const iterator& lhs, const iterator& rhs) noexcept
+        {
+            return lhs.m_block_length == 0 ? 0 : (lhs.m_entry - rhs.m_entry) / lhs.m_block_length;
+        }
+
+        constexpr bool operator==(const iterator& rhs) const noexcept { return m_entry == rhs.m_entry; }
+        constexpr std::strong_ordering operator<=>(const iterator& rhs) const noexcept
+        {
+            return std::compare_three_way()(m_entry, rhs.m_entry);
+        }
+
+    private:
+        const std::byte* m_entry = nullptr;
+        difference_type m_block_length = 0;
+    };
+
+    constexpr GroupView() noexcept = default;
+
+    explicit GroupView(std::span<const std::byte> buffer) noexcept
+    {
+        if (buffer.size() < sizeof(Header))
+            return;
+        const auto header = detail_group::read_header<Header>(buffer.data());
+        const size_t block_length = header.blockLength();
+        const size_t count = header.numInGroup();
+        const auto available = buffer.size() - sizeof(Header);
+        if (block_length < sizeof(Entry) || (count > 0 && available / block_length < count))
+            return;
+        m_entries = buffer.data() + sizeof(Header);
+        m_block_length = block_length;
+        m_size = count;
+        m_tail = buffer.subspan(sizeof(Header) + count * block_length);
+        m_valid = true;
+    }
+
+    // false if the buffer is too small for the header or the entries, the view is then empty
+    bool valid() const noexcept { return m_valid; }
+    explicit operator bool() const noexcept { return m_valid; }
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    size_t block_length() const noexcept { return m_block_length; }
+
+    const Entry& operator[](size_t i) const noexcept { return *reinterpret_cast<const Entry*>(m_entries + i * m_block_length); }
+    const Entry& front() const noexcept { return (*this)[0]; }
+    const Entry& back() const noexcept { return (*this)[m_size - 1]; }
+
+    iterator begin() const noexcept { return iterator(m_entries, m_block_length); }
+    iterator end() const noexcept { return iterator(m_entries + m_size * m_block_length, m_block_length); }
+
+    // whole group (header included)
+    size_t byte_size() const noexcept { return m_valid ? sizeof(Header) + m_size * m_block_length : 0; }
+
+    // what follows the group (e.g. the next group or variable length data)
+    std::span<const std::byte> tail() const noexcept { return m_tail; }
+
+private:
+    const std::byte* m_entries = nullptr;
+    size_t m_block_length = 0;
+    size_t m_size = 0;
+    std::span<const std::byte> m_tail;
+    bool m_valid = false;
+};
+
+// Forward only cursor over a group whose entries are followed by nested groups (or
+// variable length data). Each entry's nested data is decoded from nested(), and the
+// cursor is resumed where that decoding ended, so that no byte is walked twice:
+//
+//     GroupCursor<Header, Outer> outer(buffer);
+//     while (outer.next())
+//     {
+//         GroupView<Header, Inner> inner(outer.nested());
+//         ...
+//         outer.resume(inner.tail());
+//     }
+//     auto next = outer.tail();
+//
+// If resume() is not called, the entry is assumed to have no nested data.
+
+template<group_header Header, group_entry Entry>
+class GroupCursor
+{
+public:
+    using header_type = Header;
+    using entry_type = Entry;
+
+    constexpr GroupCursor() noexcept = default;
+
+    explicit GroupCursor(std::span<const std::byte> buffer) noexcept
+    {
+        if (buffer.size() < sizeof(Header))
+            return;
+        const auto header = detail_group::read_header<Header>(buffer.data());
+        m_block_length = header.blockLength();
+        m_size = header.numInGroup();
+        if (m_block_length < sizeof(Entry))
+            return;
+        m_next = buffer.data() + sizeof(Header);
+        m_end = buffer.data() + buffer.size();
+        m_valid = true;
+    }
+
+    // moves to the next entry, returns false after the last entry or if the buffer is too small
+    bool next() noexcept
+    {
+        if (!m_valid || m_index == m_size)
+            return false;
+        if (static_cast<size_t>(m_end - m_next) < m_block_length)
+        {
+            m_valid = false;
+            return false;
+        }
+        m_entry = m_next;
+        m_next += m_block_length;
+        ++m_index;
+        return true;
+    }
+
+    const Entry& entry() const noexcept { return *reinterpret_cast<const Entry*>(m_entry); }
+    const Entry& operator*() const noexcept { return entry(); }
+    const Entry* operator->() const noexcept { return &entry(); }
+
+    // what follows the current entry's block (i.e. its nested groups)
+    std::span<const std::byte> nested() const noexcept { return { m_next, m_end }; }
+
+    // moves past the current entry's nested data, tail being what follows it
+    void resume(std::span<const std::byte> tail) noexcept
+    {
+        if (tail.data() < m_next || tail.data() > m_end)
+            m_valid = false;
+        else
+            m_next = tail.data();
+    }
+
+    bool valid() const noexcept { return m_valid; }
+    explicit operator bool() const noexcept { return m_valid; }
+
+    size_t size() const noexcept { return m_size; }
+    size_t index() const noexcept { return m_index - 1; }
+    size_t block_length() const noexcept { return m_block_length; }
+
+    // what follows the group, once next() returned false (empty if the group is not valid)
+    std::span<const std::byte> tail() const noexcept
+    {
+        if (!m_valid || m_index != m_size)
+            return {};
+        return { m_next, m_end };
+    }
+
+private:
+    const std::byte* m_entry = nullptr;
+    const std::byte* m_next = nullptr;
+    const std::byte* m_end = nullptr;
+    size_t m_block_length = 0;
+    size_t m_size = 0;
+    size_t m_index = 0;
+    bool m_valid = false;
+};
+
+}  // namespace openmsg
@@ -0,0 +1,218 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/group.hpp"
+#include "openmsg/message_view.hpp"
+#include "openmsg/reflection.hpp"
+#include "openmsg/var_data.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+namespace openmsg {
+
+// Offsets of the variable length sections (groups and variable length data) of a message,
+// found in a single walk of the buffer, so that any section is then reached directly
+// rather than by walking all the sections before it:
+//
+//     struct Msg
+//     {
+//         ...
+//         using sections = Sections<Section<"legs", legs_group>, Section<"note", note_data>>;
+//     };
+//
+//     IndexedMessage<Msg> msg(buffer, header.blockLength());
+//     if (!msg)
+//         return;
+//     auto note = msg.section<"note">();  // a VarData, without walking the legs
+//     auto legs = msg.section<0>();       // a GroupCursor over the legs only
+//
+// Sections are GroupView, GroupCursor or VarData (any type constructed from a buffer with
+// valid(), tail() and byte_size(), or next(), nested() and resume() for a cursor), declared
+// in wire order. The entries of a GroupCursor declare their own sections (nested groups),
+// which are walked to find the end of the group. sbe_codegen generates the declarations.
+//
+// The offsets are an array sized at compile time, IndexedMessage does not allocate.
+
+template<fixed_string _name, typename T>
+struct Section
+{
+    using type = T;
+    constexpr static std::string_view name = _name.view();
+};
+
+template<typename... S>
+struct Sections
+{
+    constexpr static size_t size = sizeof...(S);
+};
+
+namespace detail_indexed {
+
+template<typename T> struct is_sections : std::false_type {};
+template<typename... S> struct is_sections<Sections<S...>> : std::true_type {};
+
+// sections of a message or of a group entry, none if it does not declare them
+template<typename T> struct sections_of { using type = Sections<>; };
+template<typename T> requires requires { typename T::sections; } struct sections_of<T> { using type = typename T::sections; };
+template<typename T> using sections_of_t = typename sections_of<T>::type;
+
+template<typename T> concept cursor = requires(T& s, std::span<const std::byte> buffer)
+{
+    typename T::entry_type;
+    { s.next() } -> std::same_as<bool>;
+    { s.nested() } -> std::same_as<std::span<const std::byte>>;
+    s.resume(buffer);
+};
+
+template<size_t I, typename First, typename... Rest>
+struct nth : nth<I - 1, Rest...> {};
+template<typename First, typename... Rest>
+struct nth<0, First, Rest...> { using type = First; };
+
+template<typename... S>
+constexpr size_t index_of(Sections<S...>, std::string_view name) noexcept
+{
+    constexpr std::string_view names[] = { S::name..., "" };
+    for (size_t i = 0; i < sizeof...(S); ++i)
+        if (names[i] == name)
+            return i;
+    return sizeof...(S);
+}
+
+template<typename... S>
+const std::byte* walk(Sections<S...>, std::span<const std::byte> buffer, size_t* offsets, const std::byte* origin) noexcept;
+
+// end of the section at the beginning of buffer, nullptr if the buffer is too small
+template<typename T>
+const std::byte* skip(std::span<const std::byte> buffer) noexcept
+{
+    T section(buffer);
+    if constexpr (cursor<T>)
+    {
+        while (section.next())
+        {
+            const auto nested = section.nested();
+            const auto end = walk(sections_of_t<typename T::entry_type>{}, nested, nullptr, nullptr);
+            if (end == nullptr)
+                return nullptr;
+            section.resume(nested.subspan(static_cast<size_t>(end - nested.data())));
+        }
+        return section.valid() ? section.tail().data() : nullptr;
+    }
+    else
+        return section.valid() ? buffer.data() + section.byte_size() : nullptr;
+}
+
+// end of the sections at the beginning of buffer (nullptr if the buffer is too small), the
+// offsets of the sections from origin are written to offsets (if not null)
+template<typename... S>
+const std::byte* walk(Sections<S...>, std::span<const std::byte> buffer, [[maybe_unused]] size_t* offsets, [[maybe_unused]] const std::byte* origin) noexcept
+{
+    const std::byte* cursor = buffer.data();
+    [[maybe_unused]] const std::byte* const end = buffer.data() + buffer.size();
+    [[maybe_unused]] size_t i = 0;
+    const bool complete = ([&]()
+    {
+        if (offsets != nullptr)
+            offsets[i++] = static_cast<size_t>(cursor - origin);
+        cursor = skip<typename S::type>({ cursor, end });
+        return cursor != nullptr;
+    }() && ...);
+    return complete ? cursor : nullptr;
+}
+
+}  // namespace detail_indexed
+
+template<wire_message Msg, typename SectionList = detail_indexed::sections_of_t<Msg>>
+requires detail_indexed::is_sections<SectionList>::value
+class IndexedMessage
+{
+    template<fixed_string Name> constexpr static size_t index_of = detail_indexed::index_of(SectionList{}, Name.view());
+
+    template<size_t I, typename... S>
+    constexpr static auto section_type(Sections<S...>) noexcept -> typename detail_indexed::nth<I, S..., void>::type::type;
+
+public:
+    using message_type = Msg;
+    using sections_type = SectionList;
+    constexpr static size_t section_count = SectionList::size;
+    template<size_t I> using section_t = decltype(section_type<I>(SectionList{}));
+
+    constexpr IndexedMessage() noexcept = default;
+
+    // block_length may be larger than sizeof(Msg), as for MessageView
+    explicit IndexedMessage(std::span<const std::byte> buffer, size_t block_length = sizeof(Msg)) noexcept
+        : m_view(buffer, block_length)
+    {
+        if (!m_view)
+            return;
+        const auto end = detail_indexed::walk(SectionList{}, m_view.tail(), m_offsets.data(), buffer.data());
+        if (end == nullptr)
+        {
+            m_view = {};
+            return;
+        }
+        m_offsets[section_count] = static_cast<size_t>(end - buffer.data());
+        m_tail = buffer.subspan(m_offsets[section_count]);
+    }
+
+    // false if the buffer is too small for the message or any of its sections
+    bool valid() const noexcept { return m_view.valid(); }
+    explicit operator bool() const noexcept { return valid(); }
+
+    // fixed size part of the message
+    const MessageView<Msg>& message() const noexcept { return m_view; }
+
+    // section I, over the bytes of that section only
+    template<size_t I>
+    requires (I < section_count)
+    section_t<I> section() const noexcept
+    {
+        return section_t<I>(section_bytes(I));
+    }
+
+    template<fixed_string Name>
+    requires (index_of<Name> < section_count)
+    section_t<index_of<Name>> section() const noexcept
+    {
+        return section<index_of<Name>>();
+    }
+
+    // offset of section i from the start of the message (i == section_count: end of the last section)
+    size_t offset(size_t i) const noexcept { return m_offsets[i]; }
+
+    std::span<const std::byte> section_bytes(size_t i) const noexcept
+    {
+        return { m_view.data() + m_offsets[i], m_offsets[i + 1] - m_offsets[i] };
+    }
+
+    // whole message, sections included
+    size_t byte_size() const noexcept { return valid() ? m_offsets[section_count] : 0; }
+    std::span<const std::byte> bytes() const noexcept { return { m_view.data(), byte_size() }; }
+
+    // what follows the message (e.g. the next message)
+    std::span<const std::byte> tail() const noexcept { return m_tail; }
+
+private:
+    MessageView<Msg> m_view;
+    std::array<size_t, section_count + 1> m_offsets = {};
+    std::span<const std::byte> m_tail;
+};
+
+}  // namespace openmsg
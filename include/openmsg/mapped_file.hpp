@@ -0,0 +1,194 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include <cstddef>
+#include <span>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OPENMSG_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h>
+#endif
+
+namespace openmsg {
+
+// prefetch of data which is about to be read (no effect if not supported)
+inline void prefetch(const void* p) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+struct MappingOptions
+{
+    bool populate = true;     // pages are read when mapping (MAP_POPULATE), rather than on first access
+    bool sequential = true;   // the file is read forward (MADV_SEQUENTIAL), the kernel reads ahead more
+    bool huge_pages = false;  // transparent huge pages are asked for (MADV_HUGEPAGE), if supported
+};
+
+// A read only file, memory mapped where supported (otherwise read into memory), e.g. a
+// capture of messages to replay:
+//
+//     MappedFile file("messages.bin");
+//     if (!file)
+//         return;
+//     std::span<const std::byte> bytes = file.data();
+
+class MappedFile
+{
+public:
+    MappedFile() noexcept = default;
+
+    explicit MappedFile(const char* path, MappingOptions options = {}) noexcept
+    {
+        open(path, options);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& rhs) noexcept
+    {
+        swap(rhs);
+    }
+
+    MappedFile& operator=(MappedFile&& rhs) noexcept
+    {
+        MappedFile(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+        close();
+    }
+
+    // false if the file could not be opened or mapped
+    bool open(const char* path, MappingOptions options = {}) noexcept
+    {
+        close();
+#if defined(OPENMSG_MMAP)
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size == 0)
+        {
+            ::close(fd);
+            m_valid = true;
+            return true;
+        }
+        int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+        if (options.populate)
+            flags |= MAP_POPULATE;
+#endif
+        void* p = ::mmap(nullptr, m_size, PROT_READ, flags, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+        {
+            m_size = 0;
+            return false;
+        }
+        m_data = static_cast<const std::byte*>(p);
+        if (options.sequential)
+            ::madvise(p, m_size, MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+        if (options.huge_pages)
+            ::madvise(p, m_size, MADV_HUGEPAGE);
+#endif
+        m_valid = true;
+        return true;
+#else
+        (void)options;
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        try
+        {
+            m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        catch (...)
+        {
+            return false;
+        }
+        m_data = reinterpret_cast<const std::byte*>(m_buffer.data());
+        m_size = m_buffer.size();
+        m_valid = true;
+        return true;
+#endif
+    }
+
+    void close() noexcept
+    {
+#if defined(OPENMSG_MMAP)
+        if (m_data != nullptr)
+            ::munmap(const_cast<std::byte*>(m_data), m_size);
+#else
+        m_buffer.clear();
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_valid = false;
+    }
+
+    bool valid() const noexcept { return m_valid; }
+    explicit operator bool() const noexcept { return m_valid; }
+
+    std::span<const std::byte> data() const noexcept { return { m_data, m_size }; }
+    size_t size() const noexcept { return m_size; }
+
+    void swap(MappedFile& rhs) noexcept
+    {
+        std::swap(m_data, rhs.m_data);
+        std::swap(m_size, rhs.m_size);
+        std::swap(m_valid, rhs.m_valid);
+#if !defined(OPENMSG_MMAP)
+        std::swap(m_buffer, rhs.m_buffer);
+#endif
+    }
+
+private:
+    const std::byte* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_valid = false;
+#if !defined(OPENMSG_MMAP)
+    std::vector<char> m_buffer;
+#endif
+};
+
+}  // namespace openmsg
@@ -29,6 +29,13 @@
 #include "immintrin.h"
 #endif
 
+// movbe loads are used explicitly by memory_wrapper_movbe if the target supports them (e.g.
+// -mmovbe, -march=haswell or later, up to 32-bit values on i386), define OPENMSG_NO_MOVBE_ASM
+// to leave it to the compiler
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__MOVBE__) && (defined(__x86_64__) || defined(__i386__)) && !defined(OPENMSG_NO_MOVBE_ASM)
+#define OPENMSG_MOVBE_ASM 1
+#endif
+
 namespace openmsg {
 
 // openmsg does not take side with regards to memory aliasing and
@@ -143,14 +150,25 @@ struct memory_wrapper_movbe
             return std::bit_cast<HostType>(y);
         else
         {
-#if defined(MSC_VER)
+#if defined(_MSC_VER)
             if constexpr (sizeof(memory_type) == 2)
-                return std::bit_cast<HostType>(_load_be_u16(&y));
+                return std::bit_cast<HostType>(_load_be_u16(&x));
             if constexpr (sizeof(memory_type) == 4)
-                return std::bit_cast<HostType>(_load_be_u32(&y));
+                return std::bit_cast<HostType>(_load_be_u32(&x));
             if constexpr (sizeof(memory_type) == 8)
-                return std::bit_cast<HostType>(_load_be_u64(&y));
+                return std::bit_cast<HostType>(_load_be_u64(&x));
+#elif defined(OPENMSG_MOVBE_ASM)
+            if constexpr (sizeof(memory_type) <= sizeof(void*))  // 64-bit values do not fit in a register on i386
+            {
+                // load and swap from memory in a single instruction
+                memory_type swapped;
+                asm("movbe %1, %0" : "=r"(swapped) : "m"(x));
+                return std::bit_cast<HostType>(swapped);
+            }
+            else
+                return memory_wrapper_bswap<HostType, _endian>::mtoh(x);
 #else
+            // __builtin_bswap of the loaded value, fused into movbe by GCC/Clang with -mmovbe
             return memory_wrapper_bswap<HostType, _endian>::mtoh(x);
 #endif
         }
@@ -175,6 +193,7 @@ struct memory_wrapper_movbe
                 _store_be_u64(&dst, y);
             return dst;
 #else
+            // the value is returned (not stored), GCC/Clang fuse the swap with the caller's store into movbe with -mmovbe
             return memory_wrapper_bswap<HostType, _endian>::htom(x);
 #endif
         }
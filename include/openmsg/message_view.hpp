@@ -0,0 +1,158 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace openmsg {
+
+template<typename T> concept wire_message = std::is_trivially_copyable_v<T> && alignof(T) == 1;  // i.e. packed
+
+namespace detail_message {
+
+template<typename T> struct member_pointer;
+template<typename C, typename M> struct member_pointer<M C::*>
+{
+    using class_type = C;
+    using member_type = M;
+};
+
+template<auto Member> using class_of_t = typename member_pointer<decltype(Member)>::class_type;
+template<auto Member> using member_of_t = typename member_pointer<decltype(Member)>::member_type;
+
+// storage for a Msg which is not constructed, only used to compute member addresses
+template<typename Msg>
+union storage
+{
+    char none;
+    Msg msg;
+    constexpr storage() noexcept : none() {}
+};
+
+// offset of a member, folded into a constant by the compiler
+template<auto Member>
+inline size_t offset_of() noexcept
+{
+    storage<class_of_t<Member>> s;
+    return static_cast<size_t>(reinterpret_cast<const std::byte*>(&(s.msg.*Member)) - reinterpret_cast<const std::byte*>(&s.msg));
+}
+
+}  // namespace detail_message
+
+// A view of a message (a packed structure) over a buffer, e.g. received from the network.
+//
+// The size of the buffer is checked once, at construction, then members are copied
+// (memcpy) from the buffer instead of dereferencing a reinterpret_cast pointer, so that
+// there is no aliasing or lifetime issue. The copies are compiled to single loads:
+//
+//     MessageView<Msg> view(buffer);
+//     if (!view)
+//         return;
+//     auto a = view.value<&Msg::a>();     // host value of an EndianWrapper
+//     auto b = view.value<&Msg::b>(1);    // host value of an array element
+//     auto d = view.field<&Msg::d>();     // copy of any member, e.g. an ArrayChar
+//     MessageView<Next> next(view.tail());
+//
+// Members must only be accessed if the view is valid.
+
+template<wire_message Msg>
+class MessageView
+{
+    template<auto Member>
+    constexpr static bool is_member = std::is_member_object_pointer_v<decltype(Member)> && std::is_same_v<detail_message::class_of_t<Member>, Msg>;
+
+public:
+    using message_type = Msg;
+
+    constexpr MessageView() noexcept = default;
+
+    // block_length may be larger than sizeof(Msg) (e.g. SBE messages of a newer schema version),
+    // the extra bytes are skipped
+    explicit MessageView(std::span<const std::byte> buffer, size_t block_length = sizeof(Msg)) noexcept
+    {
+        if (block_length < sizeof(Msg) || buffer.size() < block_length)
+            return;
+        m_data = buffer.data();
+        m_block_length = block_length;
+        m_tail = buffer.subspan(block_length);
+    }
+
+    // false if the buffer is too small, the view is then empty
+    bool valid() const noexcept { return m_data != nullptr; }
+    explicit operator bool() const noexcept { return valid(); }
+
+    // copy of a member
+    template<auto Member>
+    requires is_member<Member> && (!std::is_array_v<detail_message::member_of_t<Member>>)
+    detail_message::member_of_t<Member> field() const noexcept
+    {
+        using M = detail_message::member_of_t<Member>;
+        M member;
+        std::memcpy(&member, m_data + detail_message::offset_of<Member>(), sizeof(M));
+        return member;
+    }
+
+    // copy of an element of an array member
+    template<auto Member>
+    requires is_member<Member> && (std::rank_v<detail_message::member_of_t<Member>> == 1)
+    std::remove_extent_t<detail_message::member_of_t<Member>> field(size_t i) const noexcept
+    {
+        using E = std::remove_extent_t<detail_message::member_of_t<Member>>;
+        E element;
+        std::memcpy(&element, m_data + detail_message::offset_of<Member>() + i * sizeof(E), sizeof(E));
+        return element;
+    }
+
+    // host value of a member (e.g. an EndianWrapper)
+    template<auto Member>
+    requires is_member<Member>
+    auto value() const noexcept
+    {
+        return field<Member>()();
+    }
+
+    template<auto Member>
+    requires is_member<Member>
+    auto value(size_t i) const noexcept
+    {
+        return field<Member>(i)();
+    }
+
+    // copy of the whole message
+    Msg get() const noexcept
+    {
+        Msg msg;
+        std::memcpy(&msg, m_data, sizeof(Msg));
+        return msg;
+    }
+
+    const std::byte* data() const noexcept { return m_data; }
+
+    // message bytes (block length)
+    std::span<const std::byte> bytes() const noexcept { return { m_data, m_block_length }; }
+    size_t block_length() const noexcept { return m_block_length; }
+
+    // what follows the message (e.g. groups, variable length data, or the next message)
+    std::span<const std::byte> tail() const noexcept { return m_tail; }
+
+private:
+    const std::byte* m_data = nullptr;
+    size_t m_block_length = 0;
+    std::span<const std::byte> m_tail;
+};
+
+}  // namespace openmsg
@@ -0,0 +1,422 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/bitfield.hpp"
+#include "openmsg/checksum.hpp"
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/reflection.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <inttypes.h>
+#include <span>
+
+namespace openmsg::net {
+
+// Link, network and transport layer headers (network byte order, i.e. big endian)
+
+enum class EtherType : uint16_t
+{
+    ipv4 = 0x0800,
+    arp = 0x0806,
+    vlan = 0x8100,  // IEEE 802.1Q
+    ipv6 = 0x86DD,
+    qinq = 0x88A8,  // IEEE 802.1ad
+};
+
+enum class IpProtocol : uint8_t
+{
+    hop_by_hop = 0,
+    tcp = 6,
+    udp = 17,
+    routing = 43,
+    fragment = 44,
+    no_next_header = 59,
+    destination_options = 60,
+};
+
+#pragma pack(push, 1)
+
+struct MacAddress
+{
+    uint8_t bytes[6];
+};
+OPENMSG_FIELDS(MacAddress, bytes)
+
+struct EthernetHeader
+{
+    MacAddress destination;
+    MacAddress source;
+    BigEndian<EtherType> etherType;
+};
+OPENMSG_FIELDS(EthernetHeader, destination, source, etherType)
+
+// follows the source address of an Ethernet header, the etherType is the one of what follows the tag
+struct VlanTag
+{
+    BitPack<be_uint16_t, BitField<"priority", 13, 3>, BitField<"dei", 12, 1>, BitField<"vlanId", 0, 12>> tci;
+    BigEndian<EtherType> etherType;
+
+    constexpr uint8_t priority() const noexcept { return tci.get<"priority">(); }
+    constexpr uint16_t vlanId() const noexcept { return tci.get<"vlanId">(); }
+};
+OPENMSG_FIELDS(VlanTag, tci, etherType)
+
+struct Ipv4Header
+{
+    BitPack<be_uint8_t, BitField<"version", 4, 4>, BitField<"ihl", 0, 4>> versionIhl;
+    BitPack<be_uint8_t, BitField<"dscp", 2, 6>, BitField<"ecn", 0, 2>> dscpEcn;
+    be_uint16_t totalLength;
+    be_uint16_t identification;
+    BitPack<be_uint16_t, BitField<"flags", 13, 3>, BitField<"fragmentOffset", 0, 13>> flagsFragmentOffset;
+    be_uint8_t ttl;
+    BigEndian<IpProtocol> protocol;
+    be_uint16_t checksum;
+    be_uint32_t source;
+    be_uint32_t destination;
+
+    constexpr uint8_t version() const noexcept { return versionIhl.get<"version">(); }
+    constexpr size_t headerLength() const noexcept { return static_cast<size_t>(versionIhl.get<"ihl">()) * 4; }  // with options
+    constexpr bool moreFragments() const noexcept { return (flagsFragmentOffset.get<"flags">() & 1) != 0; }
+    constexpr uint16_t fragmentOffset() const noexcept { return static_cast<uint16_t>(flagsFragmentOffset.get<"fragmentOffset">() * 8); }  // bytes
+};
+OPENMSG_FIELDS(Ipv4Header, versionIhl, dscpEcn, totalLength, identification, flagsFragmentOffset, ttl, protocol, checksum, source, destination)
+
+struct Ipv6Header
+{
+    BitPack<be_uint32_t, BitField<"version", 28, 4>, BitField<"trafficClass", 20, 8>, BitField<"flowLabel", 0, 20>> versionClassLabel;
+    be_uint16_t payloadLength;
+    BigEndian<IpProtocol> nextHeader;
+    be_uint8_t hopLimit;
+    uint8_t source[16];
+    uint8_t destination[16];
+
+    constexpr uint8_t version() const noexcept { return versionClassLabel.get<"version">(); }
+    constexpr uint32_t flowLabel() const noexcept { return versionClassLabel.get<"flowLabel">(); }
+};
+OPENMSG_FIELDS(Ipv6Header, versionClassLabel, payloadLength, nextHeader, hopLimit, source, destination)
+
+// hop-by-hop, routing and destination options headers
+struct Ipv6ExtensionHeader
+{
+    BigEndian<IpProtocol> nextHeader;
+    be_uint8_t length;  // in 8 bytes, not including the first 8 bytes
+
+    constexpr size_t byteLength() const noexcept { return (static_cast<size_t>(length()) + 1) * 8; }
+};
+OPENMSG_FIELDS(Ipv6ExtensionHeader, nextHeader, length)
+
+struct Ipv6FragmentHeader
+{
+    BigEndian<IpProtocol> nextHeader;
+    be_uint8_t reserved;
+    BitPack<be_uint16_t, BitField<"fragmentOffset", 3, 13>, BitField<"moreFragments", 0, 1>> offsetFlags;
+    be_uint32_t identification;
+
+    constexpr uint16_t fragmentOffset() const noexcept { return static_cast<uint16_t>(offsetFlags.get<"fragmentOffset">() * 8); }  // bytes
+    constexpr bool moreFragments() const noexcept { return offsetFlags.get<"moreFragments">() != 0; }
+};
+OPENMSG_FIELDS(Ipv6FragmentHeader, nextHeader, reserved, offsetFlags, identification)
+
+struct UdpHeader
+{
+    be_uint16_t sourcePort;
+    be_uint16_t destinationPort;
+    be_uint16_t length;  // with the header
+    be_uint16_t checksum;
+};
+OPENMSG_FIELDS(UdpHeader, sourcePort, destinationPort, length, checksum)
+
+struct TcpHeader
+{
+    be_uint16_t sourcePort;
+    be_uint16_t destinationPort;
+    be_uint32_t sequenceNumber;
+    be_uint32_t acknowledgmentNumber;
+    BitPack<be_uint16_t, BitField<"dataOffset", 12, 4>, BitField<"flags", 0, 9>> offsetFlags;
+    be_uint16_t window;
+    be_uint16_t checksum;
+    be_uint16_t urgentPointer;
+
+    constexpr size_t headerLength() const noexcept { return static_cast<size_t>(offsetFlags.get<"dataOffset">()) * 4; }  // with options
+    constexpr uint16_t flags() const noexcept { return offsetFlags.get<"flags">(); }
+
+    constexpr static uint16_t fin = 0x01;
+    constexpr static uint16_t syn = 0x02;
+    constexpr static uint16_t rst = 0x04;
+    constexpr static uint16_t psh = 0x08;
+    constexpr static uint16_t ack = 0x10;
+    constexpr static uint16_t urg = 0x20;
+};
+OPENMSG_FIELDS(TcpHeader, sourcePort, destinationPort, sequenceNumber, acknowledgmentNumber, offsetFlags, window, checksum, urgentPointer)
+
+#pragma pack(pop)
+
+static_assert(sizeof(EthernetHeader) == 14 && sizeof(VlanTag) == 4);
+static_assert(sizeof(Ipv4Header) == 20 && sizeof(Ipv6Header) == 40 && sizeof(Ipv6FragmentHeader) == 8);
+static_assert(sizeof(UdpHeader) == 8 && sizeof(TcpHeader) == 20);
+
+// Link layer of a frame (pcap LINKTYPE_ values)
+
+enum class LinkType : uint16_t
+{
+    ethernet = 1,
+    raw = 101,  // IPv4 or IPv6, from the version
+    ipv4 = 228,
+    ipv6 = 229,
+};
+
+// Headers of a frame, pointing into the frame (nullptr if absent). The payload is the
+// transport payload (UDP or TCP), or what follows the last decoded header, and is
+// bounded by the IP and UDP lengths (e.g. Ethernet padding is removed).
+
+struct Layers
+{
+    const EthernetHeader* ethernet = nullptr;
+    const VlanTag* vlan = nullptr;  // outer tag
+    size_t vlan_count = 0;
+    const Ipv4Header* ipv4 = nullptr;
+    const Ipv6Header* ipv6 = nullptr;
+    IpProtocol protocol = IpProtocol::no_next_header;  // transport protocol
+    bool fragment = false;  // not the first fragment, the transport header is not in the frame
+    const UdpHeader* udp = nullptr;
+    const TcpHeader* tcp = nullptr;
+    std::span<const std::byte> payload;
+    bool truncated = false;  // a header did not fit in the frame (or had an invalid length)
+
+    bool is_udp() const noexcept { return udp != nullptr; }
+    bool is_tcp() const noexcept { return tcp != nullptr; }
+};
+
+namespace detail_net {
+
+template<typename Header>
+inline const Header* header(std::span<const std::byte>& bytes, size_t size = sizeof(Header)) noexcept
+{
+    if (size < sizeof(Header) || bytes.size() < size)
+        return nullptr;
+    auto p = reinterpret_cast<const Header*>(bytes.data());
+    bytes = bytes.subspan(size);
+    return p;
+}
+
+inline void decode_transport(std::span<const std::byte> bytes, Layers& layers) noexcept
+{
+    layers.payload = bytes;
+    if (layers.fragment)
+        return;
+    if (layers.protocol == IpProtocol::udp)
+    {
+        layers.udp = header<UdpHeader>(bytes);
+        if (layers.udp == nullptr)
+        {
+            layers.truncated = true;
+            return;
+        }
+        const size_t length = layers.udp->length();
+        layers.payload = bytes.first(std::min(bytes.size(), length < sizeof(UdpHeader) ? size_t{ 0 } : length - sizeof(UdpHeader)));
+    }
+    else if (layers.protocol == IpProtocol::tcp)
+    {
+        if (bytes.size() < sizeof(TcpHeader))
+        {
+            layers.truncated = true;
+            return;
+        }
+        layers.tcp = header<TcpHeader>(bytes, reinterpret_cast<const TcpHeader*>(bytes.data())->headerLength());
+        layers.truncated = layers.tcp == nullptr;
+        layers.payload = layers.tcp != nullptr ? bytes : std::span<const std::byte>();
+    }
+}
+
+inline void decode_ipv4(std::span<const std::byte> bytes, Layers& layers) noexcept
+{
+    if (bytes.size() < sizeof(Ipv4Header))
+    {
+        layers.truncated = true;
+        return;
+    }
+    const auto ip = reinterpret_cast<const Ipv4Header*>(bytes.data());
+    const size_t total_length = ip->totalLength();
+    const size_t header_length = ip->headerLength();
+    if (header_length < sizeof(Ipv4Header) || total_length < header_length || bytes.size() < header_length)
+    {
+        layers.truncated = true;
+        return;
+    }
+    layers.ipv4 = ip;
+    layers.protocol = ip->protocol();
+    layers.fragment = ip->fragmentOffset() != 0;
+    decode_transport(bytes.first(std::min(bytes.size(), total_length)).subspan(header_length), layers);
+}
+
+inline void decode_ipv6(std::span<const std::byte> bytes, Layers& layers) noexcept
+{
+    layers.ipv6 = header<Ipv6Header>(bytes);
+    if (layers.ipv6 == nullptr)
+    {
+        layers.truncated = true;
+        return;
+    }
+    bytes = bytes.first(std::min(bytes.size(), static_cast<size_t>(layers.ipv6->payloadLength())));
+    auto next = layers.ipv6->nextHeader();
+    for (;;)
+    {
+        if (next == IpProtocol::hop_by_hop || next == IpProtocol::routing || next == IpProtocol::destination_options)
+        {
+            auto extension = bytes.size() >= sizeof(Ipv6ExtensionHeader) ? reinterpret_cast<const Ipv6ExtensionHeader*>(bytes.data()) : nullptr;
+            if (extension == nullptr || header<Ipv6ExtensionHeader>(bytes, extension->byteLength()) == nullptr)
+                break;
+            next = extension->nextHeader();
+        }
+        else if (next == IpProtocol::fragment)
+        {
+            auto fragment = header<Ipv6FragmentHeader>(bytes);
+            if (fragment == nullptr)
+                break;
+            layers.fragment = fragment->fragmentOffset() != 0;
+            next = fragment->nextHeader();
+        }
+        else
+        {
+            layers.protocol = next;
+            decode_transport(bytes, layers);
+            return;
+        }
+    }
+    layers.truncated = true;
+}
+
+}  // namespace detail_net
+
+// decodes the headers of a frame, without copying
+inline Layers decode_layers(std::span<const std::byte> frame, LinkType link_type = LinkType::ethernet) noexcept
+{
+    Layers layers;
+    auto bytes = frame;
+    auto ether_type = EtherType::ipv4;
+    switch (link_type)
+    {
+    case LinkType::ethernet:
+        layers.ethernet = detail_net::header<EthernetHeader>(bytes);
+        if (layers.ethernet == nullptr)
+        {
+            layers.truncated = true;
+            return layers;
+        }
+        ether_type = layers.ethernet->etherType();
+        while (ether_type == EtherType::vlan || ether_type == EtherType::qinq)
+        {
+            auto tag = detail_net::header<VlanTag>(bytes);
+            if (tag == nullptr)
+            {
+                layers.truncated = true;
+                return layers;
+            }
+            if (layers.vlan == nullptr)
+                layers.vlan = tag;
+            ++layers.vlan_count;
+            ether_type = tag->etherType();
+        }
+        break;
+    case LinkType::raw:
+        if (bytes.empty())
+        {
+            layers.truncated = true;
+            return layers;
+        }
+        ether_type = (std::to_integer<uint8_t>(bytes[0]) >> 4) == 6 ? EtherType::ipv6 : EtherType::ipv4;
+        break;
+    case LinkType::ipv4:
+        ether_type = EtherType::ipv4;
+        break;
+    case LinkType::ipv6:
+        ether_type = EtherType::ipv6;
+        break;
+    default:
+        layers.payload = bytes;
+        return layers;
+    }
+    layers.payload = bytes;
+    if (ether_type == EtherType::ipv4)
+        detail_net::decode_ipv4(bytes, layers);
+    else if (ether_type == EtherType::ipv6)
+        detail_net::decode_ipv6(bytes, layers);
+    return layers;
+}
+
+// Checksums, computed as if the checksum field were zero (so that they can be compared
+// with the one of the header, or written in it)
+
+namespace detail_net {
+
+constexpr uint16_t sum_words(uint32_t value) noexcept
+{
+    return ones_complement_add(static_cast<uint16_t>(value >> 16), static_cast<uint16_t>(value));
+}
+
+// ones' complement sum of data whose checksum field holds checksum, the field counted as zero
+inline uint16_t sum_without(std::span<const std::byte> data, uint16_t checksum) noexcept
+{
+    return ones_complement_add(ones_complement_sum(data), static_cast<uint16_t>(~checksum));
+}
+
+}  // namespace detail_net
+
+// checksum of an IPv4 header, with its options
+inline uint16_t ipv4_checksum(const Ipv4Header& header) noexcept
+{
+    const std::span<const std::byte> bytes(reinterpret_cast<const std::byte*>(&header), std::max(header.headerLength(), sizeof(Ipv4Header)));
+    return static_cast<uint16_t>(~detail_net::sum_without(bytes, header.checksum()));
+}
+
+// sum of the IPv4 or IPv6 pseudo-header of a transport segment of length bytes
+inline uint16_t pseudo_header_sum(const Layers& layers, size_t length) noexcept
+{
+    uint16_t sum = detail_net::sum_words(static_cast<uint32_t>(length));
+    sum = ones_complement_add(sum, static_cast<uint8_t>(layers.protocol));
+    if (layers.ipv4 != nullptr)
+    {
+        sum = ones_complement_add(sum, detail_net::sum_words(layers.ipv4->source()));
+        return ones_complement_add(sum, detail_net::sum_words(layers.ipv4->destination()));
+    }
+    if (layers.ipv6 != nullptr)
+        return ones_complement_sum(std::as_bytes(std::span(layers.ipv6->source)), ones_complement_sum(std::as_bytes(std::span(layers.ipv6->destination)), sum));
+    return sum;
+}
+
+// UDP or TCP segment (header and payload) of decoded layers, empty if there is none
+inline std::span<const std::byte> transport_segment(const Layers& layers) noexcept
+{
+    const void* header = layers.udp != nullptr ? static_cast<const void*>(layers.udp) : static_cast<const void*>(layers.tcp);
+    if (header == nullptr || layers.truncated)
+        return {};
+    const auto first = static_cast<const std::byte*>(header);
+    return { first, static_cast<size_t>(layers.payload.data() + layers.payload.size() - first) };
+}
+
+// checksum of the UDP or TCP segment of decoded layers (0 if there is none)
+inline uint16_t transport_checksum(const Layers& layers) noexcept
+{
+    const auto segment = transport_segment(layers);
+    if (segment.empty())
+        return 0;
+    const uint16_t checksum = layers.udp != nullptr ? layers.udp->checksum() : layers.tcp->checksum();
+    const auto sum = ones_complement_add(pseudo_header_sum(layers, segment.size()), detail_net::sum_without(segment, checksum));
+    const auto result = static_cast<uint16_t>(~sum);
+    return layers.udp != nullptr && result == 0 ? uint16_t{ 0xFFFF } : result;  // 0 means no UDP checksum
+}
+
+}  // namespace openmsg::net
@@ -14,14 +14,36 @@
 #endif
 
 #include "openmsg/array_char.hpp"
+#include "openmsg/ascii_number.hpp"
 #include "openmsg/attributes.hpp"
+#include "openmsg/bitfield.hpp"
 #include "openmsg/bounds.hpp"
 #include "openmsg/bswap.hpp"
+#include "openmsg/bulk.hpp"
+#include "openmsg/capture.hpp"
+#include "openmsg/checksum.hpp"
+#include "openmsg/columns.hpp"
 #include "openmsg/concepts.hpp"
+#include "openmsg/decimal.hpp"
+#include "openmsg/decoded.hpp"
+#include "openmsg/dispatcher.hpp"
 #include "openmsg/endian_wrapper.hpp"
+#include "openmsg/group.hpp"
+#include "openmsg/indexed_message.hpp"
+#include "openmsg/mapped_file.hpp"
 #include "openmsg/memory_wrapper.hpp"
+#include "openmsg/message_view.hpp"
+#include "openmsg/net.hpp"
 #include "openmsg/optionull.hpp"
+#include "openmsg/patch.hpp"
+#include "openmsg/pcap.hpp"
 #include "openmsg/presence.hpp"
+#include "openmsg/prototype.hpp"
+#include "openmsg/reflection.hpp"
+#include "openmsg/simd.hpp"
+#include "openmsg/symbol_table.hpp"
 #include "openmsg/type_traits.hpp"
 #include "openmsg/type.hpp"
 #include "openmsg/user_definitions.hpp"
+#include "openmsg/validate.hpp"
+#include "openmsg/var_data.hpp"
@@ -0,0 +1,315 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/message_view.hpp"
+#include "openmsg/reflection.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+#include <span>
+#include <type_traits>
+
+namespace openmsg {
+
+// In-place modification of a message (a packed, reflectable structure, see reflection.hpp)
+// in a mutable buffer, recording which fields were written, e.g. by a forwarder rewriting
+// a few fields of the messages it receives:
+//
+//     Patch<Msg> patch(buffer);
+//     if (!patch)
+//         return;
+//     patch.set<"seqNum">(next_sequence_number);
+//     patch.set<"sendingTime">(now);
+//
+//     patch.for_each_dirty_range([&](ByteRange range)
+//     {
+//         journal(patch.bytes(range));  // only what was written
+//     });
+//     patch.clear();
+//
+// Like MessageView, fields are copied from and to the buffer (memcpy). The dirty fields are
+// a bitmask sized at compile time (one bit per field), as are the dirty elements of array
+// fields (one bit per element). The dirty byte ranges are the ones of the written fields,
+// or of the written elements of array fields, in offset order, adjacent or overlapping ones
+// merged.
+
+struct ByteRange
+{
+    size_t offset = 0;  // from the start of the message
+    size_t size = 0;
+
+    constexpr size_t end() const noexcept { return offset + size; }
+    constexpr bool operator==(const ByteRange&) const noexcept = default;
+};
+
+namespace detail_patch {
+
+// byte ranges of the fields, by field index
+template<typename Msg>
+constexpr auto field_ranges() noexcept
+{
+    std::array<ByteRange, field_count<Msg>> ranges = {};
+    size_t i = 0;
+    for_each_field<Msg>([&](auto field)
+    {
+        using F = decltype(field);
+        ranges[i++] = { F::offset, F::size };
+    });
+    return ranges;
+}
+
+// bit of the first element of each array field in the element mask (none for other fields),
+// field i has firsts[i + 1] - firsts[i] elements in the mask
+template<typename Msg>
+constexpr auto element_firsts() noexcept
+{
+    std::array<size_t, field_count<Msg> + 1> firsts = {};
+    size_t i = 0;
+    for_each_field<Msg>([&](auto field)
+    {
+        using F = decltype(field);
+        firsts[i + 1] = firsts[i] + (F::is_array ? F::extent : 0);
+        ++i;
+    });
+    return firsts;
+}
+
+// field indexes sorted by offset
+template<typename Msg>
+constexpr auto offset_order() noexcept
+{
+    constexpr auto ranges = field_ranges<Msg>();
+    std::array<size_t, field_count<Msg>> order = {};
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return ranges[a].offset < ranges[b].offset; });
+    return order;
+}
+
+// host value written to a field (or to an element of an array field)
+template<typename Field>
+using input_t = std::conditional_t<Field::is_wrapper, typename Field::value_type, typename Field::element_type>;
+
+}  // namespace detail_patch
+
+template<typename Msg>
+requires wire_message<Msg> && reflectable<Msg>
+class Patch
+{
+    template<fixed_string Name> constexpr static size_t index_of = field_index<Msg>(Name.view());
+    template<fixed_string Name> using field_of = field_t<Msg, index_of<Name>>;
+
+    constexpr static auto s_ranges = detail_patch::field_ranges<Msg>();
+    constexpr static auto s_order = detail_patch::offset_order<Msg>();
+    constexpr static auto s_elements = detail_patch::element_firsts<Msg>();
+
+public:
+    using message_type = Msg;
+    constexpr static size_t mask_words = (field_count<Msg> + 63) / 64;
+    using mask_type = std::array<uint64_t, mask_words>;  // bit i % 64 of word i / 64 for field i
+
+    Patch() noexcept = default;
+
+    // block_length may be larger than sizeof(Msg), as for MessageView
+    explicit Patch(std::span<std::byte> buffer, size_t block_length = sizeof(Msg)) noexcept
+    {
+        if (block_length < sizeof(Msg) || buffer.size() < block_length)
+            return;
+        m_data = buffer.data();
+        m_block_length = block_length;
+    }
+
+    // false if the buffer is too small
+    bool valid() const noexcept { return m_data != nullptr; }
+    explicit operator bool() const noexcept { return valid(); }
+
+    // writes
+
+    template<fixed_string Name>
+    requires (index_of<Name> < field_count<Msg> && !field_of<Name>::is_array)
+    void set(const detail_patch::input_t<field_of<Name>>& value) noexcept
+    {
+        using F = field_of<Name>;
+        const typename F::member_type member(value);
+        std::memcpy(m_data + F::offset, &member, sizeof(member));
+        mark(index_of<Name>);
+    }
+
+    // element i of an array field, false if i is out of the array (nothing is written)
+    template<fixed_string Name>
+    requires (index_of<Name> < field_count<Msg> && field_of<Name>::is_array)
+    bool set(size_t i, const detail_patch::input_t<field_of<Name>>& value) noexcept
+    {
+        using F = field_of<Name>;
+        if (i >= F::extent)
+            return false;
+        const typename F::element_type element(value);
+        std::memcpy(m_data + F::offset + i * sizeof(element), &element, sizeof(element));
+        mark(index_of<Name>);
+        const auto bit = s_elements[index_of<Name>] + i;
+        m_dirty_elements[bit / 64] |= uint64_t{ 1 } << (bit % 64);
+        return true;
+    }
+
+    // reads
+
+    template<fixed_string Name>
+    requires (index_of<Name> < field_count<Msg> && !field_of<Name>::is_array)
+    auto value() const noexcept
+    {
+        using F = field_of<Name>;
+        typename F::member_type member;
+        std::memcpy(&member, m_data + F::offset, sizeof(member));
+        if constexpr (F::is_wrapper)
+            return member();
+        else
+            return member;
+    }
+
+    // element i of an array field, i < extent of the array (checked by assert() only)
+    template<fixed_string Name>
+    requires (index_of<Name> < field_count<Msg> && field_of<Name>::is_array)
+    auto value(size_t i) const noexcept
+    {
+        using F = field_of<Name>;
+        assert(i < F::extent);
+        typename F::element_type element;
+        std::memcpy(&element, m_data + F::offset + i * sizeof(element), sizeof(element));
+        if constexpr (F::is_wrapper)
+            return element();
+        else
+            return element;
+    }
+
+    // copy of the whole message
+    Msg get() const noexcept
+    {
+        Msg msg;
+        std::memcpy(&msg, m_data, sizeof(Msg));
+        return msg;
+    }
+
+    // dirty fields
+
+    bool is_dirty(size_t i) const noexcept { return (m_dirty[i / 64] >> (i % 64)) & 1; }
+
+    template<fixed_string Name>
+    requires (index_of<Name> < field_count<Msg>)
+    bool is_dirty() const noexcept
+    {
+        return is_dirty(index_of<Name>);
+    }
+
+    const mask_type& dirty() const noexcept { return m_dirty; }
+
+    bool any_dirty() const noexcept
+    {
+        return std::any_of(m_dirty.begin(), m_dirty.end(), [](uint64_t word) { return word != 0; });
+    }
+
+    size_t dirty_count() const noexcept
+    {
+        size_t n = 0;
+        for (auto word : m_dirty)
+            n += static_cast<size_t>(std::popcount(word));
+        return n;
+    }
+
+    void clear() noexcept
+    {
+        m_dirty = {};
+        m_dirty_elements = {};
+    }
+
+    // byte range of field i
+    constexpr static ByteRange field_range(size_t i) noexcept { return s_ranges[i]; }
+
+    // calls f(ByteRange) for each range of dirty bytes, in offset order
+    template<typename F>
+    void for_each_dirty_range(F&& f) const
+    {
+        ByteRange current;
+        bool open = false;
+        const auto add = [&](ByteRange range)
+        {
+            if (open && range.offset <= current.end())
+                current.size = std::max(current.end(), range.end()) - current.offset;
+            else
+            {
+                if (open)
+                    f(current);
+                current = range;
+                open = true;
+            }
+        };
+        for (auto i : s_order)
+        {
+            if (!is_dirty(i))
+                continue;
+            if constexpr (s_elements.back() != 0)  // some array fields
+            {
+                const auto first = s_elements[i];
+                const auto count = s_elements[i + 1] - first;
+                if (count != 0)
+                {
+                    // written elements only
+                    const auto element_size = s_ranges[i].size / count;
+                    for (size_t k = first; k < first + count; ++k)
+                        if ((m_dirty_elements[k / 64] >> (k % 64)) & 1)
+                            add({ s_ranges[i].offset + (k - first) * element_size, element_size });
+                    continue;
+                }
+            }
+            add(s_ranges[i]);
+        }
+        if (open)
+            f(current);
+    }
+
+    // dirty byte ranges written into ranges (up to its size), returns the number of dirty ranges
+    size_t dirty_ranges(std::span<ByteRange> ranges) const noexcept
+    {
+        size_t n = 0;
+        for_each_dirty_range([&](ByteRange range)
+        {
+            if (n < ranges.size())
+                ranges[n] = range;
+            ++n;
+        });
+        return n;
+    }
+
+    // message bytes (block length), and bytes of a range
+    std::span<std::byte> bytes() const noexcept { return { m_data, m_block_length }; }
+    std::span<std::byte> bytes(ByteRange range) const noexcept { return bytes().subspan(range.offset, range.size); }
+
+    std::byte* data() const noexcept { return m_data; }
+    size_t block_length() const noexcept { return m_block_length; }
+
+private:
+    void mark(size_t i) noexcept { m_dirty[i / 64] |= uint64_t{ 1 } << (i % 64); }
+
+    std::byte* m_data = nullptr;
+    size_t m_block_length = 0;
+    mask_type m_dirty = {};
+    std::array<uint64_t, (s_elements.back() + 63) / 64> m_dirty_elements = {};
+};
+
+}  // namespace openmsg
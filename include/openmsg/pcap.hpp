@@ -0,0 +1,405 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/mapped_file.hpp"
+#include "openmsg/net.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+#include <span>
+#include <vector>
+
+namespace openmsg::net {
+
+// pcap and pcapng file structures, in the byte order of the file (or of the pcapng section)
+
+#pragma pack(push, 1)
+
+template<template<typename...> class _W = LittleEndian>
+struct PcapFileHeader
+{
+    _W<uint32_t> magic;  // 0xA1B2C3D4 (microseconds) or 0xA1B23C4D (nanoseconds)
+    _W<uint16_t> versionMajor;
+    _W<uint16_t> versionMinor;
+    _W<int32_t> thisZone;
+    _W<uint32_t> sigFigs;
+    _W<uint32_t> snapLen;
+    _W<uint32_t> linkType;  // LinkType in the low 16 bits
+};
+
+template<template<typename...> class _W = LittleEndian>
+struct PcapRecordHeader
+{
+    _W<uint32_t> seconds;
+    _W<uint32_t> fraction;  // microseconds or nanoseconds
+    _W<uint32_t> capturedLength;
+    _W<uint32_t> originalLength;
+};
+
+template<template<typename...> class _W = LittleEndian>
+struct PcapngBlockHeader
+{
+    _W<uint32_t> type;
+    _W<uint32_t> totalLength;  // whole block, followed by totalLength again
+};
+
+template<template<typename...> class _W = LittleEndian>
+struct PcapngSectionHeader
+{
+    PcapngBlockHeader<_W> block;
+    _W<uint32_t> byteOrderMagic;  // 0x1A2B3C4D
+    _W<uint16_t> versionMajor;
+    _W<uint16_t> versionMinor;
+    _W<int64_t> sectionLength;
+};
+
+template<template<typename...> class _W = LittleEndian>
+struct PcapngInterfaceDescription
+{
+    PcapngBlockHeader<_W> block;
+    _W<uint16_t> linkType;
+    _W<uint16_t> reserved;
+    _W<uint32_t> snapLen;
+};
+
+template<template<typename...> class _W = LittleEndian>
+struct PcapngEnhancedPacket
+{
+    PcapngBlockHeader<_W> block;
+    _W<uint32_t> interfaceId;
+    _W<uint32_t> timestampHigh;
+    _W<uint32_t> timestampLow;
+    _W<uint32_t> capturedLength;
+    _W<uint32_t> originalLength;
+};
+
+template<template<typename...> class _W = LittleEndian>
+struct PcapngSimplePacket
+{
+    PcapngBlockHeader<_W> block;
+    _W<uint32_t> originalLength;
+};
+
+template<template<typename...> class _W = LittleEndian>
+struct PcapngOption
+{
+    _W<uint16_t> code;
+    _W<uint16_t> length;  // value length, the value is padded to 4 bytes
+};
+
+#pragma pack(pop)
+
+enum class CaptureFormat : int
+{
+    unknown = 0,
+    pcap = 1,
+    pcapng = 2,
+};
+
+// A captured frame, pointing into the capture
+
+struct Packet
+{
+    uint64_t timestamp_ns = 0;  // since the epoch
+    uint32_t original_length = 0;  // on the wire, the frame may have been truncated by the capture
+    uint32_t interface_index = 0;  // pcapng interface id, 0 in pcap files
+    LinkType link_type = LinkType::ethernet;
+    std::span<const std::byte> frame;
+
+    Layers layers() const noexcept { return decode_layers(frame, link_type); }
+};
+
+namespace detail_pcap {
+
+constexpr uint32_t pcap_magic_us = 0xA1B2C3D4;
+constexpr uint32_t pcap_magic_ns = 0xA1B23C4D;
+constexpr uint32_t section_header_block = 0x0A0D0D0A;
+constexpr uint32_t interface_description_block = 1;
+constexpr uint32_t simple_packet_block = 3;
+constexpr uint32_t enhanced_packet_block = 6;
+constexpr uint32_t byte_order_magic = 0x1A2B3C4D;
+constexpr uint16_t pcap_version_major = 2;
+constexpr uint16_t pcapng_version_major = 1;
+constexpr uint16_t if_tsresol = 9;
+
+template<typename T>
+inline T read(const std::byte* src) noexcept
+{
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return value;
+}
+
+// timestamp in units of if_tsresol (10^-n seconds, or 2^-n if the top bit is set) to nanoseconds
+constexpr uint64_t to_nanoseconds(uint64_t timestamp, uint8_t resolution) noexcept
+{
+    if (resolution & 0x80)
+    {
+        auto shift = resolution & 0x7F;
+        if (shift >= 64)
+            return 0;
+        const auto seconds = timestamp >> shift;
+        auto fraction = timestamp & ((uint64_t{ 1 } << shift) - 1);
+        if (shift > 34)  // fraction * 10^9 must fit in 64 bits
+        {
+            fraction >>= shift - 34;
+            shift = 34;
+        }
+        return seconds * 1000000000u + ((fraction * 1000000000u) >> shift);
+    }
+    if (resolution > 28)
+        return 0;
+    uint64_t scale = 1;
+    for (int i = 9; i != resolution; i += resolution < 9 ? -1 : 1)
+        scale *= 10;
+    return resolution <= 9 ? timestamp * scale : timestamp / scale;
+}
+
+struct Interface
+{
+    LinkType link_type = LinkType::ethernet;
+    uint8_t resolution = 6;  // microseconds
+};
+
+}  // namespace detail_pcap
+
+// Zero-copy reader of pcap and pcapng captures, typically a MappedFile:
+//
+//     MappedFile file("capture.pcapng");
+//     PcapReader reader(file.data());
+//     Packet packets[64];
+//     while (size_t n = reader.next(packets))
+//         for (const auto& packet : std::span(packets, n))
+//             if (auto layers = packet.layers(); layers.is_udp())
+//                 decode(layers.payload);
+//
+// pcap files of either byte order, with microsecond or nanosecond timestamps, and pcapng
+// sections of either byte order (interfaces and their timestamp resolution, simple and
+// enhanced packet blocks, other blocks are skipped) are supported, for pcap version 2 and
+// pcapng version 1 (other major versions are invalid). Reading stops at the first
+// truncated or malformed record, valid() is then false.
+
+class PcapReader
+{
+public:
+    constexpr static size_t default_prefetch_distance = 512;
+
+    PcapReader() noexcept = default;
+
+    explicit PcapReader(std::span<const std::byte> buffer, size_t prefetch_distance = default_prefetch_distance)
+        : m_buffer(buffer), m_prefetch_distance(prefetch_distance)
+    {
+        using namespace detail_pcap;
+        bool supported_version = true;  // of pcap files, pcapng versions are checked per section
+        if (buffer.size() >= sizeof(PcapFileHeader<>))
+        {
+            const auto magic = read<PcapFileHeader<LittleEndian>>(buffer.data()).magic();
+            const auto swapped_magic = read<PcapFileHeader<BigEndian>>(buffer.data()).magic();
+            if (magic == pcap_magic_us || magic == pcap_magic_ns || swapped_magic == pcap_magic_us || swapped_magic == pcap_magic_ns)
+            {
+                m_format = CaptureFormat::pcap;
+                m_big_endian = swapped_magic == pcap_magic_us || swapped_magic == pcap_magic_ns;
+                const auto header_magic = m_big_endian ? swapped_magic : magic;
+                const auto link_type = m_big_endian ? read<PcapFileHeader<BigEndian>>(buffer.data()).linkType() : read<PcapFileHeader<LittleEndian>>(buffer.data()).linkType();
+                const auto version_major = m_big_endian ? read<PcapFileHeader<BigEndian>>(buffer.data()).versionMajor() : read<PcapFileHeader<LittleEndian>>(buffer.data()).versionMajor();
+                supported_version = version_major == pcap_version_major;
+                m_interfaces.push_back({ static_cast<LinkType>(link_type & 0xFFFF), static_cast<uint8_t>(header_magic == pcap_magic_ns ? 9 : 6) });
+                m_position = sizeof(PcapFileHeader<>);
+            }
+        }
+        if (m_format == CaptureFormat::unknown && buffer.size() >= sizeof(PcapngBlockHeader<>) &&
+            read<PcapngBlockHeader<LittleEndian>>(buffer.data()).type() == section_header_block)
+            m_format = CaptureFormat::pcapng;
+        m_valid = m_format != CaptureFormat::unknown && supported_version;
+    }
+
+    // next packet, false at the end of the capture or on a truncated record
+    bool next(Packet& packet)
+    {
+        if (!m_valid)
+            return false;
+        if (m_prefetch_distance != 0 && m_position + m_prefetch_distance < m_buffer.size())
+            prefetch(m_buffer.data() + m_position + m_prefetch_distance);
+        if (m_format == CaptureFormat::pcap)
+            return m_big_endian ? next_pcap<BigEndian>(packet) : next_pcap<LittleEndian>(packet);
+        while (m_position < m_buffer.size())
+        {
+            const auto found = m_big_endian ? next_pcapng<BigEndian>(packet) : next_pcapng<LittleEndian>(packet);
+            if (found || !m_valid)
+                return found;
+        }
+        return false;
+    }
+
+    // next packets (up to packets.size()), returns the number of packets read
+    size_t next(std::span<Packet> packets)
+    {
+        size_t n = 0;
+        while (n < packets.size() && next(packets[n]))
+            ++n;
+        return n;
+    }
+
+    CaptureFormat format() const noexcept { return m_format; }
+
+    // false if the capture format is unknown, or a truncated or malformed record was found
+    bool valid() const noexcept { return m_valid; }
+    explicit operator bool() const noexcept { return m_valid; }
+
+    bool at_end() const noexcept { return m_position == m_buffer.size(); }
+
+    // packets read so far
+    size_t count() const noexcept { return m_count; }
+
+private:
+    bool invalid() noexcept
+    {
+        m_valid = false;
+        return false;
+    }
+
+    bool end() noexcept
+    {
+        m_valid = m_position == m_buffer.size();
+        return false;
+    }
+
+    template<template<typename...> class W>
+    bool next_pcap(Packet& packet) noexcept
+    {
+        using Header = PcapRecordHeader<W>;
+        if (m_buffer.size() - m_position < sizeof(Header))
+            return end();
+        const auto header = detail_pcap::read<Header>(m_buffer.data() + m_position);
+        const size_t captured = header.capturedLength();
+        if (captured > m_buffer.size() - m_position - sizeof(Header))
+            return invalid();
+        const auto& iface = m_interfaces.front();
+        packet.timestamp_ns = static_cast<uint64_t>(header.seconds()) * 1000000000u + static_cast<uint64_t>(header.fraction()) * (iface.resolution == 9 ? 1u : 1000u);
+        packet.original_length = header.originalLength();
+        packet.interface_index = 0;
+        packet.link_type = iface.link_type;
+        packet.frame = m_buffer.subspan(m_position + sizeof(Header), captured);
+        m_position += sizeof(Header) + captured;
+        ++m_count;
+        return true;
+    }
+
+    // reads a block, true if it is a packet
+    template<template<typename...> class W>
+    bool next_pcapng(Packet& packet)
+    {
+        using namespace detail_pcap;
+        const auto remaining = m_buffer.size() - m_position;
+        if (remaining < sizeof(PcapngBlockHeader<>))
+            return end();
+        const auto block_start = m_buffer.data() + m_position;
+        const auto block = read<PcapngBlockHeader<W>>(block_start);
+        if (block.type() == section_header_block)
+        {
+            if (remaining < sizeof(PcapngSectionHeader<>))
+                return invalid();
+            const auto magic = read<PcapngSectionHeader<LittleEndian>>(block_start).byteOrderMagic();
+            if (magic != byte_order_magic && read<PcapngSectionHeader<BigEndian>>(block_start).byteOrderMagic() != byte_order_magic)
+                return invalid();
+            m_big_endian = magic != byte_order_magic;
+            const auto version_major = m_big_endian ? read<PcapngSectionHeader<BigEndian>>(block_start).versionMajor() : read<PcapngSectionHeader<LittleEndian>>(block_start).versionMajor();
+            if (version_major != pcapng_version_major)
+                return invalid();
+            m_interfaces.clear();
+            const size_t length = m_big_endian ? read<PcapngBlockHeader<BigEndian>>(block_start).totalLength() : read<PcapngBlockHeader<LittleEndian>>(block_start).totalLength();
+            if (length < sizeof(PcapngSectionHeader<>) + 4 || length % 4 != 0 || length > remaining)
+                return invalid();
+            m_position += length;
+            return false;
+        }
+        const size_t length = block.totalLength();
+        if (length < sizeof(PcapngBlockHeader<>) + 4 || length % 4 != 0 || length > remaining)
+            return invalid();
+        const auto body_end = length - 4;  // trailing totalLength
+        m_position += length;
+        switch (block.type())
+        {
+        case interface_description_block:
+        {
+            if (body_end < sizeof(PcapngInterfaceDescription<>))
+                return invalid();
+            Interface iface;
+            iface.link_type = static_cast<LinkType>(read<PcapngInterfaceDescription<W>>(block_start).linkType());
+            for (size_t offset = sizeof(PcapngInterfaceDescription<>); offset + sizeof(PcapngOption<>) <= body_end;)
+            {
+                const auto option = read<PcapngOption<W>>(block_start + offset);
+                const size_t option_length = option.length();
+                offset += sizeof(PcapngOption<>);
+                if (option.code() == 0 || offset + option_length > body_end)
+                    break;
+                if (option.code() == if_tsresol && option_length >= 1)
+                    iface.resolution = std::to_integer<uint8_t>(block_start[offset]);
+                offset += (option_length + 3) & ~size_t{ 3 };
+            }
+            m_interfaces.push_back(iface);
+            return false;
+        }
+        case enhanced_packet_block:
+        {
+            if (body_end < sizeof(PcapngEnhancedPacket<>))
+                return invalid();
+            const auto header = read<PcapngEnhancedPacket<W>>(block_start);
+            const size_t captured = header.capturedLength();
+            if (header.interfaceId() >= m_interfaces.size() || captured > body_end - sizeof(PcapngEnhancedPacket<>))
+                return invalid();
+            const auto& iface = m_interfaces[header.interfaceId()];
+            const auto timestamp = (static_cast<uint64_t>(header.timestampHigh()) << 32) | header.timestampLow();
+            packet.timestamp_ns = to_nanoseconds(timestamp, iface.resolution);
+            packet.original_length = header.originalLength();
+            packet.interface_index = header.interfaceId();
+            packet.link_type = iface.link_type;
+            packet.frame = { block_start + sizeof(PcapngEnhancedPacket<>), captured };
+            ++m_count;
+            return true;
+        }
+        case simple_packet_block:
+        {
+            if (body_end < sizeof(PcapngSimplePacket<>) || m_interfaces.empty())
+                return invalid();
+            const auto header = read<PcapngSimplePacket<W>>(block_start);
+            const size_t captured = std::min<size_t>(header.originalLength(), body_end - sizeof(PcapngSimplePacket<>));
+            packet.timestamp_ns = 0;  // not recorded
+            packet.original_length = header.originalLength();
+            packet.interface_index = 0;
+            packet.link_type = m_interfaces.front().link_type;
+            packet.frame = { block_start + sizeof(PcapngSimplePacket<>), captured };
+            ++m_count;
+            return true;
+        }
+        default:
+            return false;  // skipped
+        }
+    }
+
+    std::span<const std::byte> m_buffer;
+    size_t m_position = 0;
+    size_t m_count = 0;
+    size_t m_prefetch_distance = default_prefetch_distance;
+    std::vector<detail_pcap::Interface> m_interfaces;
+    CaptureFormat m_format = CaptureFormat::unknown;
+    bool m_big_endian = false;
+    bool m_valid = false;
+};
+
+}  // namespace openmsg::net
@@ -0,0 +1,100 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/message_view.hpp"
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+namespace openmsg {
+
+// Wire image of a message rendered at compile time, e.g. of a default initialized message
+// (nullValues of the optional fields, default member initializers) or of a message with
+// its constant fields set:
+//
+//     constexpr Prototype<NewOrder> new_order([]
+//     {
+//         NewOrder msg;
+//         msg.header.templateId = NewOrder::templateId;
+//         return msg;
+//     }());
+//
+//     new_order.render(buffer);  // a single copy of the image
+//     Patch<NewOrder> order(buffer);
+//     order.set<"price">(price);  // then only the fields which change
+//
+// prototype<Msg> is the image of Msg{}. Rendering copies the image (64-byte aligned)
+// rather than running the constructors of the members, e.g. the byte swap of the
+// nullValues of EndianWrapper.
+
+constexpr size_t prototype_alignment = 64;  // a cache line
+
+template<typename Msg>
+requires wire_message<Msg> && std::default_initializable<Msg>
+class Prototype
+{
+public:
+    using message_type = Msg;
+    using image_type = std::array<std::byte, sizeof(Msg)>;
+
+    // image of Msg{}
+    constexpr Prototype() noexcept
+        : m_image(std::bit_cast<image_type>(Msg{}))
+    {
+    }
+
+    constexpr explicit Prototype(const Msg& msg) noexcept
+        : m_image(std::bit_cast<image_type>(msg))
+    {
+    }
+
+    constexpr const image_type& image() const noexcept { return m_image; }
+    constexpr std::span<const std::byte, sizeof(Msg)> bytes() const noexcept { return m_image; }
+
+    // copy of the message
+    Msg get() const noexcept
+    {
+        Msg msg;
+        render(msg);
+        return msg;
+    }
+
+    void render(Msg& msg) const noexcept
+    {
+        std::memcpy(static_cast<void*>(&msg), m_image.data(), sizeof(Msg));
+    }
+
+    // false if the buffer is too small (it is then left as it is)
+    bool render(std::span<std::byte> buffer) const noexcept
+    {
+        if (buffer.size() < sizeof(Msg))
+            return false;
+        std::memcpy(buffer.data(), m_image.data(), sizeof(Msg));
+        return true;
+    }
+
+private:
+    alignas(prototype_alignment) image_type m_image;
+};
+
+template<typename Msg>
+requires wire_message<Msg> && std::default_initializable<Msg>
+inline constexpr Prototype<Msg> prototype{};
+
+}  // namespace openmsg
@@ -0,0 +1,192 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/endian_wrapper.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace openmsg {
+
+// Compile-time descriptors of the fields of a message, registered with OPENMSG_FIELDS
+// next to the message (in the same namespace, the registration is found by ADL):
+//
+//     struct Msg
+//     {
+//         BigEndian<uint32_t> a;
+//         BigEndian<Optionull<int16_t>> b[4];
+//         ArrayChar<8> c;
+//     };
+//     OPENMSG_FIELDS(Msg, a, b, c)
+//
+//     for_each_field<Msg>([&](auto field)
+//     {
+//         using F = decltype(field);  // F::name, F::offset, F::extent, F::endian, ...
+//         const auto& member = F::get(msg);
+//     });
+//
+// Generic algorithms are unrolled at compile time, there is no runtime schema.
+
+template<size_t N>
+struct fixed_string
+{
+    char value[N] = {};
+
+    constexpr fixed_string(const char (&s)[N]) noexcept
+    {
+        for (size_t i = 0; i < N; ++i)
+            value[i] = s[i];
+    }
+
+    constexpr std::string_view view() const noexcept { return { value, N - 1 }; }
+};
+
+namespace detail_reflection {
+
+template<typename T> struct member_pointer;
+template<typename C, typename M> struct member_pointer<M C::*>
+{
+    using class_type = C;
+    using member_type = M;
+};
+
+template<typename T>
+constexpr auto attributes_of() noexcept
+{
+    if constexpr (endian_wrapper<T>)
+        return std::type_identity<typename T::attributes>{};
+    else
+        return std::type_identity<void>{};
+}
+
+template<typename T>
+constexpr auto value_of() noexcept
+{
+    if constexpr (requires { typename T::value_type; })
+        return std::type_identity<typename T::value_type>{};
+    else
+        return std::type_identity<T>{};
+}
+
+template<typename T>
+constexpr std::endian endian_of() noexcept
+{
+    if constexpr (endian_wrapper<T>)
+        return T::endian;
+    else
+        return std::endian::native;
+}
+
+}  // namespace detail_reflection
+
+template<auto Member, size_t Offset, fixed_string Name>
+requires std::is_member_object_pointer_v<decltype(Member)>
+struct FieldDescriptor
+{
+    using message_type = typename detail_reflection::member_pointer<decltype(Member)>::class_type;
+    using member_type = typename detail_reflection::member_pointer<decltype(Member)>::member_type;
+    using element_type = std::remove_all_extents_t<member_type>;  // e.g. the EndianWrapper of an array
+    using value_type = typename decltype(detail_reflection::value_of<element_type>())::type;  // host type
+    using attributes = typename decltype(detail_reflection::attributes_of<element_type>())::type;  // void if none
+
+    constexpr static auto pointer = Member;
+    constexpr static std::string_view name = Name.view();
+    constexpr static size_t offset = Offset;
+    constexpr static size_t size = sizeof(member_type);
+    constexpr static bool is_array = std::is_array_v<member_type>;
+    constexpr static size_t extent = sizeof(member_type) / sizeof(element_type);  // 1 if not an array
+    constexpr static bool is_wrapper = endian_wrapper<element_type>;
+    constexpr static bool has_attributes = !std::is_void_v<attributes>;
+    constexpr static std::endian endian = detail_reflection::endian_of<element_type>();
+
+    constexpr static const member_type& get(const message_type& msg) noexcept { return msg.*Member; }
+    constexpr static member_type& get(message_type& msg) noexcept { return msg.*Member; }
+};
+
+// registered fields of Msg, as a FieldList of FieldDescriptor
+
+template<typename... Fields>
+struct FieldList
+{
+    constexpr static size_t size = sizeof...(Fields);
+};
+
+template<typename Msg> concept reflectable = requires(const Msg* msg) { openmsg_fields(msg); };
+
+template<reflectable Msg> using fields_t = decltype(openmsg_fields(static_cast<const Msg*>(nullptr)));
+
+template<reflectable Msg> constexpr size_t field_count = fields_t<Msg>::size;
+
+namespace detail_reflection {
+
+template<size_t I, typename List> struct field_at;
+template<size_t I, typename Field, typename... Fields> struct field_at<I, FieldList<Field, Fields...>> : field_at<I - 1, FieldList<Fields...>> {};
+template<typename Field, typename... Fields> struct field_at<0, FieldList<Field, Fields...>> { using type = Field; };
+
+template<typename... Fields, typename F>
+constexpr void for_each_field(FieldList<Fields...>, F& f)
+{
+    (f(Fields{}), ...);
+}
+
+}  // namespace detail_reflection
+
+template<reflectable Msg, size_t I> using field_t = typename detail_reflection::field_at<I, fields_t<Msg>>::type;
+
+// calls f(FieldDescriptor{}) for each field, in declaration order
+template<reflectable Msg, typename F>
+constexpr void for_each_field(F&& f)
+{
+    detail_reflection::for_each_field(fields_t<Msg>{}, f);
+}
+
+// index of a field by name, field_count<Msg> if not found
+template<reflectable Msg>
+constexpr size_t field_index(std::string_view name) noexcept
+{
+    size_t index = field_count<Msg>;
+    size_t i = 0;
+    for_each_field<Msg>([&](auto field)
+    {
+        if (decltype(field)::name == name && index == field_count<Msg>)
+            index = i;
+        ++i;
+    });
+    return index;
+}
+
+}  // namespace openmsg
+
+// registration macros, members are the names of the data members of Msg (Msg must be standard-layout)
+
+#define OPENMSG_FIELD(Msg, member) ::openmsg::FieldDescriptor<&Msg::member, offsetof(Msg, member), ::openmsg::fixed_string(#member)>
+
+#define OPENMSG_FIELDS(Msg, first, ...) \
+    [[maybe_unused]] ::openmsg::FieldList<OPENMSG_FIELD(Msg, first) OPENMSG_FIELDS_REST(Msg, __VA_ARGS__)> openmsg_fields(const Msg*) noexcept;
+
+// for each (up to 256 members), using __VA_OPT__ recursion
+
+#define OPENMSG_FIELDS_REST(Msg, ...) __VA_OPT__(OPENMSG_EXPAND(OPENMSG_FIELDS_NEXT(Msg, __VA_ARGS__)))
+#define OPENMSG_FIELDS_NEXT(Msg, member, ...) , OPENMSG_FIELD(Msg, member) __VA_OPT__(OPENMSG_FIELDS_AGAIN OPENMSG_PARENS (Msg, __VA_ARGS__))
+#define OPENMSG_FIELDS_AGAIN() OPENMSG_FIELDS_NEXT
+#define OPENMSG_PARENS ()
+#define OPENMSG_EXPAND(...) OPENMSG_EXPAND4(OPENMSG_EXPAND4(OPENMSG_EXPAND4(OPENMSG_EXPAND4(__VA_ARGS__))))
+#define OPENMSG_EXPAND4(...) OPENMSG_EXPAND3(OPENMSG_EXPAND3(OPENMSG_EXPAND3(OPENMSG_EXPAND3(__VA_ARGS__))))
+#define OPENMSG_EXPAND3(...) OPENMSG_EXPAND2(OPENMSG_EXPAND2(OPENMSG_EXPAND2(OPENMSG_EXPAND2(__VA_ARGS__))))
+#define OPENMSG_EXPAND2(...) OPENMSG_EXPAND1(OPENMSG_EXPAND1(OPENMSG_EXPAND1(OPENMSG_EXPAND1(__VA_ARGS__))))
+#define OPENMSG_EXPAND1(...) __VA_ARGS__
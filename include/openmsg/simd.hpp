@@ -0,0 +1,728 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/bswap.hpp"
+#include "openmsg/type_traits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+
+// The kernels below are selected at compile time (e.g. -mssse3, -mavx2 or /arch:AVX2).
+// With GCC/Clang on x86, the bulk byte swapping kernels are also compiled for SSSE3,
+// AVX2 and AVX-512BW, and selected at runtime from the CPU features (cpuid), so that
+// a binary built for a baseline target runs at full speed on newer CPUs. Define
+// OPENMSG_NO_SIMD_DISPATCH to only use the compile time selection.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OPENMSG_SIMD_SSE2 1
+#endif
+#if defined(OPENMSG_SIMD_SSE2) && (defined(__SSSE3__) || defined(__AVX__))
+#define OPENMSG_SIMD_SSSE3 1
+#endif
+#if defined(OPENMSG_SIMD_SSE2) && defined(__AVX2__)
+#define OPENMSG_SIMD_AVX2 1
+#endif
+
+#if defined(OPENMSG_SIMD_SSE2) && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(OPENMSG_NO_SIMD_DISPATCH)
+#define OPENMSG_SIMD_DISPATCH 1
+#endif
+
+#if defined(OPENMSG_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace openmsg {
+
+namespace detail_simd {
+
+// loads and stores are done through memcpy (compiled to movdqu/vmovdqu),
+// so that pointers of any alignment and type can be used
+
+template<typename V>
+inline V load(const std::byte* src) noexcept
+{
+    V v;
+    std::memcpy(&v, src, sizeof(V));
+    return v;
+}
+
+template<typename V>
+inline void store(std::byte* dst, const V& v) noexcept
+{
+    std::memcpy(dst, &v, sizeof(V));
+}
+
+// scalar byte swapping of n values of Size bytes (src and dst may be the same)
+
+template<size_t Size>
+inline void bswap_n_scalar(const std::byte* src, std::byte* dst, size_t n) noexcept
+{
+    using U = uint_of_size_t<Size>;
+    for (size_t i = 0; i < n; ++i)
+    {
+        U x;
+        std::memcpy(&x, src + i * Size, Size);
+        x = bswap(x);
+        std::memcpy(dst + i * Size, &x, Size);
+    }
+}
+
+#if defined(OPENMSG_SIMD_SSE2)
+
+template<size_t Size>
+inline __m128i bswap128(__m128i x) noexcept
+{
+#if defined(OPENMSG_SIMD_SSSE3)
+    if constexpr (Size == 2)
+        return _mm_shuffle_epi8(x, _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1));
+    else if constexpr (Size == 4)
+        return _mm_shuffle_epi8(x, _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3));
+    else
+        return _mm_shuffle_epi8(x, _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+#else
+    // SSE2 only: swap 32-bit halves, then 16-bit halves, then bytes
+    if constexpr (Size == 8)
+        x = _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+    if constexpr (Size >= 4)
+        x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+#endif
+}
+
+#endif
+
+#if defined(OPENMSG_SIMD_AVX2)
+
+template<size_t Size>
+inline __m256i bswap256(__m256i x) noexcept
+{
+    // vpshufb works on each 128-bit lane independently
+    if constexpr (Size == 2)
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                                                      14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1));
+    else if constexpr (Size == 4)
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                                      12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3));
+    else
+        return _mm256_shuffle_epi8(x, _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+                                                      8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+#endif
+
+// byte swapping of n values of Size bytes, using the kernels selected at compile time
+
+template<size_t Size>
+requires (Size == 2 || Size == 4 || Size == 8)
+inline void bswap_n_static(const std::byte* src, std::byte* dst, size_t n) noexcept
+{
+    size_t bytes = n * Size;
+    size_t i = 0;
+#if defined(OPENMSG_SIMD_AVX2)
+    for (; i + 32 <= bytes; i += 32)
+        store(dst + i, bswap256<Size>(load<__m256i>(src + i)));
+#endif
+#if defined(OPENMSG_SIMD_SSE2)
+    for (; i + 16 <= bytes; i += 16)
+        store(dst + i, bswap128<Size>(load<__m128i>(src + i)));
+#endif
+    bswap_n_scalar<Size>(src + i, dst + i, (bytes - i) / Size);
+}
+
+// runtime dispatch
+
+enum class Isa : int
+{
+    baseline = 0,  // compile time selection
+    ssse3 = 1,
+    avx2 = 2,
+    avx512 = 3,  // AVX-512BW
+};
+
+// best instruction set of the CPU, detected once
+inline Isa detected_isa() noexcept
+{
+#if defined(OPENMSG_SIMD_DISPATCH)
+    static const Isa isa = []() noexcept
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw"))
+            return Isa::avx512;
+        if (__builtin_cpu_supports("avx2"))
+            return Isa::avx2;
+        if (__builtin_cpu_supports("ssse3"))
+            return Isa::ssse3;
+        return Isa::baseline;
+    }();
+    return isa;
+#else
+    return Isa::baseline;
+#endif
+}
+
+#if defined(OPENMSG_SIMD_DISPATCH)
+
+// pshufb mask reversing the bytes of each value of Size bytes (in 16-byte lanes)
+template<size_t Size>
+constexpr std::array<uint8_t, 64> bswap_shuffle = []()
+{
+    std::array<uint8_t, 64> mask = {};
+    for (size_t i = 0; i < mask.size(); ++i)
+    {
+        const auto j = i % 16;
+        mask[i] = static_cast<uint8_t>(j - j % Size + Size - 1 - j % Size);
+    }
+    return mask;
+}();
+
+// the vectors do not cross function boundaries, loads and stores are unaligned
+
+template<size_t Size>
+__attribute__((target("ssse3"))) inline size_t bswap_blocks_ssse3(const std::byte* src, std::byte* dst, size_t bytes) noexcept
+{
+    __m128i mask, x;
+    std::memcpy(&mask, bswap_shuffle<Size>.data(), sizeof(mask));
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16)
+    {
+        std::memcpy(&x, src + i, sizeof(x));
+        x = _mm_shuffle_epi8(x, mask);
+        std::memcpy(dst + i, &x, sizeof(x));
+    }
+    return i;
+}
+
+template<size_t Size>
+__attribute__((target("avx2"))) inline size_t bswap_blocks_avx2(const std::byte* src, std::byte* dst, size_t bytes) noexcept
+{
+    __m256i mask, x;
+    std::memcpy(&mask, bswap_shuffle<Size>.data(), sizeof(mask));
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64)
+    {
+        __m256i y;
+        std::memcpy(&x, src + i, sizeof(x));
+        std::memcpy(&y, src + i + 32, sizeof(y));
+        x = _mm256_shuffle_epi8(x, mask);
+        y = _mm256_shuffle_epi8(y, mask);
+        std::memcpy(dst + i, &x, sizeof(x));
+        std::memcpy(dst + i + 32, &y, sizeof(y));
+    }
+    for (; i + 32 <= bytes; i += 32)
+    {
+        std::memcpy(&x, src + i, sizeof(x));
+        x = _mm256_shuffle_epi8(x, mask);
+        std::memcpy(dst + i, &x, sizeof(x));
+    }
+    return i;
+}
+
+template<size_t Size>
+__attribute__((target("avx512bw"))) inline size_t bswap_blocks_avx512(const std::byte* src, std::byte* dst, size_t bytes) noexcept
+{
+    const __m512i mask = _mm512_loadu_si512(bswap_shuffle<Size>.data());
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64)
+        _mm512_storeu_si512(dst + i, _mm512_shuffle_epi8(_mm512_loadu_si512(src + i), mask));
+    return i;
+}
+
+// non-temporal variant of bswap_blocks_ssse3, dst must be 16-byte aligned
+template<size_t Size>
+__attribute__((target("ssse3"))) inline size_t stream_blocks_ssse3(const std::byte* src, std::byte* dst, size_t bytes) noexcept
+{
+    __m128i mask, x;
+    std::memcpy(&mask, bswap_shuffle<Size>.data(), sizeof(mask));
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16)
+    {
+        std::memcpy(&x, src + i, sizeof(x));
+        _mm_stream_si128(static_cast<__m128i*>(static_cast<void*>(dst + i)), _mm_shuffle_epi8(x, mask));
+    }
+    return i;
+}
+
+#endif
+
+// byte swapping of n values of Size bytes using the kernels of a given instruction set
+// (which must be supported by the CPU), the remaining bytes use the compile time kernels
+template<size_t Size>
+requires (Size == 2 || Size == 4 || Size == 8)
+inline void bswap_n_isa(Isa isa, const std::byte* src, std::byte* dst, size_t n) noexcept
+{
+    size_t i = 0;
+#if defined(OPENMSG_SIMD_DISPATCH)
+    switch (isa)
+    {
+    case Isa::avx512:
+        i = bswap_blocks_avx512<Size>(src, dst, n * Size);
+        break;
+    case Isa::avx2:
+        i = bswap_blocks_avx2<Size>(src, dst, n * Size);
+        break;
+    case Isa::ssse3:
+        i = bswap_blocks_ssse3<Size>(src, dst, n * Size);
+        break;
+    case Isa::baseline:
+    default:
+        break;
+    }
+#else
+    (void)isa;
+#endif
+    bswap_n_static<Size>(src + i, dst + i, n - i / Size);
+}
+
+// byte swapping of n values of Size bytes (src and dst may be the same, but must not partially overlap)
+
+template<size_t Size>
+requires (Size == 2 || Size == 4 || Size == 8)
+inline void bswap_n(const std::byte* src, std::byte* dst, size_t n) noexcept
+{
+#if defined(OPENMSG_SIMD_DISPATCH)
+    if (n * Size >= 32)  // not worth it for a few values
+        return bswap_n_isa<Size>(detected_isa(), src, dst, n);
+#endif
+    bswap_n_static<Size>(src, dst, n);
+}
+
+// byte swapping, or memcpy if Size is 1 (src and dst must not overlap, and may be null if n is 0)
+
+template<size_t Size>
+requires (Size == 1 || Size == 2 || Size == 4 || Size == 8)
+inline void convert_n(const std::byte* src, std::byte* dst, size_t n) noexcept
+{
+    if (n == 0)
+        return;
+    if constexpr (Size == 1)
+        std::memcpy(dst, src, n);
+    else
+        bswap_n<Size>(src, dst, n);
+}
+
+// same as convert_n, but using non-temporal stores, so that large outputs do not evict the cache
+
+template<size_t Size>
+requires (Size == 1 || Size == 2 || Size == 4 || Size == 8)
+inline void stream_n(const std::byte* src, std::byte* dst, size_t n) noexcept
+{
+    if (n == 0)
+        return;
+#if defined(OPENMSG_SIMD_SSE2)
+    const auto misalignment = reinterpret_cast<uintptr_t>(dst) % 16;
+    if (misalignment % Size != 0)  // values cannot be stored on a 16-byte boundary
+        return convert_n<Size>(src, dst, n);
+    const size_t head = std::min(n, (16 - misalignment) % 16 / Size);
+    convert_n<Size>(src, dst, head);
+    size_t bytes = (n - head) * Size;
+    src += head * Size;
+    dst += head * Size;
+    size_t i = 0;
+#if defined(OPENMSG_SIMD_DISPATCH) && !defined(OPENMSG_SIMD_SSSE3)
+    if constexpr (Size > 1)
+        if (detected_isa() >= Isa::ssse3)
+            i = stream_blocks_ssse3<Size>(src, dst, bytes);
+#endif
+    for (; i + 16 <= bytes; i += 16)
+    {
+        auto x = load<__m128i>(src + i);
+        if constexpr (Size > 1)
+            x = bswap128<Size>(x);
+        _mm_stream_si128(static_cast<__m128i*>(static_cast<void*>(dst + i)), x);
+    }
+    _mm_sfence();
+    convert_n<Size>(src + i, dst + i, (bytes - i) / Size);
+#else
+    convert_n<Size>(src, dst, n);
+#endif
+}
+
+// byte search and comparison (used by ArrayCharacter), vector loads never go past src + n,
+// and 8-byte blocks are processed as 64-bit words (SWAR) on little endian hosts
+
+constexpr uint64_t swar_ones = 0x0101010101010101ull;
+constexpr uint64_t swar_highs = 0x8080808080808080ull;
+
+inline uint64_t swar_zero_bytes(uint64_t x) noexcept
+{
+    // the lowest set bit is exact (higher bits may be false positives)
+    return (x - swar_ones) & ~x & swar_highs;
+}
+
+inline size_t mask_index(uint64_t mask) noexcept
+{
+    return static_cast<size_t>(std::countr_zero(mask));
+}
+
+// index of the first zero byte in [src, src + n), n if none
+inline size_t find_zero(const std::byte* src, size_t n) noexcept
+{
+    size_t i = 0;
+#if defined(OPENMSG_SIMD_AVX2)
+    for (; i + 32 <= n; i += 32)
+        if (auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(load<__m256i>(src + i), _mm256_setzero_si256()))))
+            return i + mask_index(mask);
+#endif
+#if defined(OPENMSG_SIMD_SSE2)
+    for (; i + 16 <= n; i += 16)
+        if (auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(load<__m128i>(src + i), _mm_setzero_si128()))))
+            return i + mask_index(mask);
+#endif
+    if constexpr (std::endian::native == std::endian::little)
+        for (; i + 8 <= n; i += 8)
+            if (auto mask = swar_zero_bytes(load<uint64_t>(src + i)))
+                return i + mask_index(mask) / 8;
+    for (; i < n; ++i)
+        if (src[i] == std::byte{0})
+            return i;
+    return n;
+}
+
+// index of the first different byte between [lhs, lhs + n) and [rhs, rhs + n), n if none
+inline size_t find_mismatch(const std::byte* lhs, const std::byte* rhs, size_t n) noexcept
+{
+    size_t i = 0;
+#if defined(OPENMSG_SIMD_AVX2)
+    for (; i + 32 <= n; i += 32)
+        if (auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(load<__m256i>(lhs + i), load<__m256i>(rhs + i)))))
+            return i + mask_index(mask);
+#endif
+#if defined(OPENMSG_SIMD_SSE2)
+    for (; i + 16 <= n; i += 16)
+        if (auto mask = 0xFFFFu & ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(load<__m128i>(lhs + i), load<__m128i>(rhs + i)))))
+            return i + mask_index(mask);
+#endif
+    if constexpr (std::endian::native == std::endian::little)
+        for (; i + 8 <= n; i += 8)
+            if (auto mask = load<uint64_t>(lhs + i) ^ load<uint64_t>(rhs + i))
+                return i + mask_index(mask) / 8;
+    for (; i < n; ++i)
+        if (lhs[i] != rhs[i])
+            return i;
+    return n;
+}
+
+// zero n bytes using vector stores, n <= MaxSize (no store wider than the destination)
+template<size_t MaxSize>
+inline void zero_n(std::byte* dst, size_t n) noexcept
+{
+    size_t i = 0;
+#if defined(OPENMSG_SIMD_AVX2)
+    if constexpr (MaxSize >= 32)
+        for (; i + 32 <= n; i += 32)
+            store(dst + i, _mm256_setzero_si256());
+#endif
+#if defined(OPENMSG_SIMD_SSE2)
+    if constexpr (MaxSize >= 16)
+        for (; i + 16 <= n; i += 16)
+            store(dst + i, _mm_setzero_si128());
+#endif
+    if constexpr (MaxSize >= 8)
+        for (; i + 8 <= n; i += 8)
+            store(dst + i, uint64_t{0});
+    for (; i < n; ++i)
+        dst[i] = std::byte{0};
+}
+
+// copy [src, src + n) into dst up to the first zero byte, and zero the rest of dst
+// up to Size, returns the number of copied bytes. [src, src + n) must be readable
+// (see ArrayCharacter::from_array_pointer() for a zero terminated string).
+template<size_t Size>
+inline size_t copy_zero_padded(const std::byte* src, size_t n, std::byte* dst) noexcept
+{
+    if constexpr (Size < 16)
+    {
+        // no vector load or store in a field smaller than a vector
+        const auto zero = static_cast<const std::byte*>(std::memchr(src, 0, n));
+        const size_t len = zero != nullptr ? static_cast<size_t>(zero - src) : n;
+        std::memcpy(dst, src, len);
+        std::memset(dst + len, 0, Size - len);
+        return len;
+    }
+    else
+    {
+        size_t i = 0;
+#if defined(OPENMSG_SIMD_SSE2)
+        for (; i + 16 <= n; i += 16)
+        {
+            auto x = load<__m128i>(src + i);
+            if (auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128()))))
+            {
+                // keep the bytes before the zero, and clear the ones after it
+                auto len = mask_index(mask);
+                auto keep = _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(len)), _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+                store(dst + i, _mm_and_si128(x, keep));
+                zero_n<Size - 16>(dst + i + 16, Size - i - 16);
+                return i + len;
+            }
+            store(dst + i, x);
+        }
+#endif
+        for (; i < n && src[i] != std::byte{0}; ++i)
+            dst[i] = src[i];
+        zero_n<Size>(dst + i, Size - i);
+        return i;
+    }
+}
+
+// 16-byte groups of control bytes (used by SymbolTable), bit i of the masks is for src[i]
+
+// bytes equal to value
+inline uint32_t match_byte16(const std::byte* src, uint8_t value) noexcept
+{
+#if defined(OPENMSG_SIMD_SSE2)
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(load<__m128i>(src), _mm_set1_epi8(static_cast<char>(value)))));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < 16; ++i)
+        mask |= static_cast<uint32_t>(src[i] == std::byte{ value }) << i;
+    return mask;
+#endif
+}
+
+// bytes with their high bit set
+inline uint32_t high_bits16(const std::byte* src) noexcept
+{
+#if defined(OPENMSG_SIMD_SSE2)
+    return static_cast<uint32_t>(_mm_movemask_epi8(load<__m128i>(src)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < 16; ++i)
+        mask |= static_cast<uint32_t>(std::to_integer<uint8_t>(src[i]) >> 7) << i;
+    return mask;
+#endif
+}
+
+// ASCII decimal digits (used by ascii_number.hpp), the first character being the most
+// significant digit. The SWAR functions take and return little endian words (the first
+// character in the lowest byte).
+
+// all the bytes of the word are digits
+constexpr bool swar_all_digits(uint64_t chunk) noexcept
+{
+    // '0'..'9' have a high nibble of 3, and still have it once 6 is added
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+// value of 8 digits
+constexpr uint32_t swar_parse_digits8(uint64_t chunk) noexcept
+{
+    chunk -= 0x3030303030303030ull;
+    chunk = chunk * 10 + (chunk >> 8);  // pairs of digits in bytes 0, 2, 4 and 6
+    chunk = (((chunk & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) + (((chunk >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+    return static_cast<uint32_t>(chunk);
+}
+
+// 8 digits of x < 10^8
+constexpr uint64_t swar_format_digits8(uint32_t x) noexcept
+{
+    uint64_t y = x / 10000 | uint64_t{ x % 10000 } << 32;             // 4 digits per 32-bit lane
+    const uint64_t hundreds = ((y * 5243) >> 19) & 0x0000007F0000007Full;  // y / 100
+    y = hundreds | (y - hundreds * 100) << 16;                         // 2 digits per 16-bit lane
+    const uint64_t tens = ((y * 103) >> 10) & 0x000F000F000F000Full;     // y / 10
+    return (tens | (y - tens * 10) << 8) + 0x3030303030303030ull;       // 1 digit per byte
+}
+
+#if defined(OPENMSG_SIMD_DISPATCH)
+
+__attribute__((target("ssse3"))) inline bool parse_digits16_ssse3(const std::byte* src, uint64_t& value) noexcept
+{
+    __m128i x;
+    std::memcpy(&x, src, sizeof(x));
+    const auto invalid = _mm_or_si128(_mm_cmplt_epi8(x, _mm_set1_epi8('0')), _mm_cmpgt_epi8(x, _mm_set1_epi8('9')));
+    if (_mm_movemask_epi8(invalid) != 0)
+        return false;
+    auto t = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+    t = _mm_maddubs_epi16(t, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1));  // 2 digits per 16-bit lane
+    t = _mm_madd_epi16(t, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));                          // 4 digits per 32-bit lane
+    t = _mm_packs_epi32(t, t);                                                                       // 4 digits per 16-bit lane
+    t = _mm_madd_epi16(t, _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));                  // 8 digits per 32-bit lane
+    const auto high = static_cast<uint32_t>(_mm_cvtsi128_si32(t));
+    const auto low = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(t, 4)));
+    value = uint64_t{ high } * 100000000 + low;
+    return true;
+}
+
+#endif
+
+// value of the 16 digits at src, false if they are not all digits
+inline bool parse_digits16(const std::byte* src, uint64_t& value) noexcept
+{
+#if defined(OPENMSG_SIMD_DISPATCH)
+#if defined(OPENMSG_SIMD_SSSE3)
+    return parse_digits16_ssse3(src, value);
+#else
+    if (detected_isa() >= Isa::ssse3)
+        return parse_digits16_ssse3(src, value);
+#endif
+#endif
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        const auto high = load<uint64_t>(src);
+        const auto low = load<uint64_t>(src + 8);
+        if (!swar_all_digits(high) || !swar_all_digits(low))
+            return false;
+        value = uint64_t{ swar_parse_digits8(high) } * 100000000 + swar_parse_digits8(low);
+        return true;
+    }
+    uint64_t v = 0;
+    for (size_t i = 0; i < 16; ++i)
+    {
+        const auto digit = static_cast<uint8_t>(std::to_integer<uint8_t>(src[i]) - '0');
+        if (digit > 9)
+            return false;
+        v = v * 10 + static_cast<uint64_t>(digit);
+    }
+    value = v;
+    return true;
+}
+
+// 16 digits of x < 10^16 at dst
+inline void format_digits16(uint64_t x, std::byte* dst) noexcept
+{
+    const auto high = static_cast<uint32_t>(x / 100000000);
+    const auto low = static_cast<uint32_t>(x % 100000000);
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        store(dst, swar_format_digits8(high));
+        store(dst + 8, swar_format_digits8(low));
+        return;
+    }
+    for (size_t i = 16; i-- > 0; x /= 10)
+        dst[i] = static_cast<std::byte>('0' + x % 10);
+}
+
+
+// ones' complement sum (RFC 1071) of the native 16-bit words of [src, src + n), a last odd
+// byte being padded with a zero byte, returned unfolded (add_carries folds it)
+
+// 64-bit addition with end-around carry
+inline uint64_t add_carry(uint64_t sum, uint64_t x) noexcept
+{
+    sum += x;
+    return sum + (sum < x);
+}
+
+inline uint16_t add_carries(uint64_t sum) noexcept
+{
+    sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return static_cast<uint16_t>((sum & 0xFFFF) + (sum >> 16));
+}
+
+inline uint64_t ones_sum_scalar(const std::byte* src, size_t n, uint64_t sum) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        sum = add_carry(sum, load<uint64_t>(src + i));
+    if (i + 4 <= n)
+    {
+        sum = add_carry(sum, load<uint32_t>(src + i));
+        i += 4;
+    }
+    if (i + 2 <= n)
+    {
+        sum = add_carry(sum, load<uint16_t>(src + i));
+        i += 2;
+    }
+    if (i < n)
+    {
+        const std::byte last[2] = { src[i], std::byte{ 0 } };
+        sum = add_carry(sum, load<uint16_t>(last));
+    }
+    return sum;
+}
+
+// the 16-bit halves of each 32-bit lane are accumulated into 32-bit lanes, which are
+// added to the 64-bit sum before they can overflow (every 32768 vectors)
+constexpr size_t ones_sum_vectors = 32768;
+
+#if defined(OPENMSG_SIMD_SSE2)
+
+inline size_t ones_sum_blocks_sse2(const std::byte* src, size_t n, uint64_t& sum) noexcept
+{
+    const __m128i low = _mm_set1_epi32(0xFFFF);
+    size_t i = 0;
+    while (i + 16 <= n)
+    {
+        const size_t end = i + std::min(n - i, ones_sum_vectors * 16);
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 16 <= end; i += 16)
+        {
+            const auto x = load<__m128i>(src + i);
+            acc = _mm_add_epi32(acc, _mm_and_si128(x, low));
+            acc = _mm_add_epi32(acc, _mm_srli_epi32(x, 16));
+        }
+        uint32_t lanes[4];
+        store(reinterpret_cast<std::byte*>(lanes), acc);
+        sum += uint64_t{ lanes[0] } + lanes[1] + lanes[2] + lanes[3];
+    }
+    return i;
+}
+
+#endif
+
+#if defined(OPENMSG_SIMD_DISPATCH)
+
+__attribute__((target("avx2"))) inline size_t ones_sum_blocks_avx2(const std::byte* src, size_t n, uint64_t& sum) noexcept
+{
+    const __m256i low = _mm256_set1_epi32(0xFFFF);
+    size_t i = 0;
+    while (i + 64 <= n)
+    {
+        const size_t end = i + std::min(n - i, ones_sum_vectors * 32);
+        __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256(), x, y;
+        for (; i + 64 <= end; i += 64)
+        {
+            std::memcpy(&x, src + i, sizeof(x));
+            std::memcpy(&y, src + i + 32, sizeof(y));
+            acc0 = _mm256_add_epi32(acc0, _mm256_and_si256(x, low));
+            acc1 = _mm256_add_epi32(acc1, _mm256_srli_epi32(x, 16));
+            acc0 = _mm256_add_epi32(acc0, _mm256_and_si256(y, low));
+            acc1 = _mm256_add_epi32(acc1, _mm256_srli_epi32(y, 16));
+        }
+        uint32_t lanes[16];
+        std::memcpy(lanes, &acc0, sizeof(acc0));
+        std::memcpy(lanes + 8, &acc1, sizeof(acc1));
+        for (auto lane : lanes)
+            sum += lane;
+    }
+    return i;
+}
+
+#endif
+
+inline uint64_t ones_sum(const std::byte* src, size_t n) noexcept
+{
+    uint64_t sum = 0;
+    size_t i = 0;
+#if defined(OPENMSG_SIMD_DISPATCH)
+    if (n >= 128 && detected_isa() >= Isa::avx2)
+        i = ones_sum_blocks_avx2(src, n, sum);
+#endif
+#if defined(OPENMSG_SIMD_SSE2)
+    i += ones_sum_blocks_sse2(src + i, n - i, sum);
+#endif
+    return ones_sum_scalar(src + i, n - i, sum);
+}
+
+}  // namespace detail_simd
+
+}  // namespace openmsg
@@ -0,0 +1,267 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/array_char.hpp"
+#include "openmsg/bswap.hpp"
+#include "openmsg/simd.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace openmsg {
+
+// Interning of symbols (ArrayCharacter of up to 16 characters, e.g. ArrayChar<8>) into
+// indexes 0, 1, 2... in insertion order, e.g. to map the symbol of each message to an
+// instrument:
+//
+//     SymbolTable<ArrayChar<8>, 4096> symbols;
+//     auto index = symbols.insert(msg.symbol);  // its index, new or not (npos if full)
+//     auto found = symbols.find(msg.symbol);    // npos if unknown
+//     symbols.symbol(index) == msg.symbol;
+//
+// The characters are hashed as one or two 64-bit words, i.e. what to_string_view() holds:
+// the bytes after the first zero are ignored. Slots are open-addressed in 16-slot groups,
+// each slot having a control byte (7 bits of the hash, or empty): a lookup compares the
+// control bytes of a group at once (SSE2), then the words of the matching slots only.
+// Everything is stored inline (no allocation), symbols cannot be removed.
+//
+// For a set of symbols known beforehand, the table may be built (e.g. constexpr) by
+// trying hash seeds until each symbol is in the first group probed for it:
+//
+//     constexpr ArrayChar<8> universe[] = { "AAPL", "MSFT", ... };
+//     constexpr SymbolTable<ArrayChar<8>, 1024> symbols(universe);
+//     static_assert(symbols.max_probe_length() == 1);
+
+namespace detail_symbol {
+
+template<typename T> struct is_array_character : std::false_type {};
+template<typename T, size_t N, bool Z> struct is_array_character<ArrayCharacter<T, N, Z>> : std::true_type {};
+
+constexpr size_t group_size = 16;
+constexpr uint8_t empty = 0x80;
+
+// seeds tried by the constructor from a set of symbols
+constexpr uint64_t seed_step = 0x9E3779B97F4A7C15ull;
+
+constexpr uint64_t mix(uint64_t h) noexcept
+{
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ull;
+    h ^= h >> 32;
+    h *= 0xD6E8FEB86659FD93ull;
+    return h ^ (h >> 32);
+}
+
+}  // namespace detail_symbol
+
+template<typename Key, size_t Capacity>
+requires detail_symbol::is_array_character<Key>::value && (Key::size <= 16) && (Capacity > 0) && (Capacity < std::numeric_limits<uint32_t>::max())
+class SymbolTable
+{
+    constexpr static size_t word_count = Key::size > 8 ? 2 : 1;
+    using words_type = std::array<uint64_t, word_count>;
+
+public:
+    using key_type = Key;
+    using index_type = uint32_t;
+    constexpr static index_type npos = std::numeric_limits<index_type>::max();
+    constexpr static size_t capacity = Capacity;
+    // at most 7/8 of the slots are used
+    constexpr static size_t group_count = std::bit_ceil((Capacity * 8 / 7 + detail_symbol::group_size) / detail_symbol::group_size);
+    constexpr static size_t slot_count = group_count * detail_symbol::group_size;
+
+    constexpr explicit SymbolTable(uint64_t seed = 0) noexcept
+        : m_seed(seed)
+    {
+        m_control.fill(detail_symbol::empty);
+    }
+
+    // table of a set of symbols (indexes in their order, duplicates having the same index),
+    // with the first of max_seeds seeds giving a single group probe for all of them, or the
+    // one with the shortest probes. Symbols beyond the capacity are not inserted.
+    constexpr explicit SymbolTable(std::span<const Key> symbols, size_t max_seeds = 64) noexcept
+    {
+        uint64_t best_seed = 0;
+        size_t best_length = std::numeric_limits<size_t>::max();
+        for (size_t i = 0; i < max_seeds && best_length > 1; ++i)
+        {
+            rebuild(symbols, i * detail_symbol::seed_step);
+            if (m_max_probe_length < best_length)
+            {
+                best_length = m_max_probe_length;
+                best_seed = m_seed;
+            }
+        }
+        if (m_seed != best_seed)
+            rebuild(symbols, best_seed);
+    }
+
+    // index of the symbol, npos if not found
+    constexpr index_type find(const Key& symbol) const noexcept
+    {
+        const auto words = words_of(symbol);
+        const auto h = hash(words);
+        const auto tag = tag_of(h);
+        for (size_t probe = 0, group = h & (group_count - 1); probe < group_count; group = (group + ++probe) & (group_count - 1))
+        {
+            for (auto matches = match(group, tag); matches != 0; matches &= matches - 1)
+            {
+                const auto slot = group * detail_symbol::group_size + static_cast<size_t>(std::countr_zero(matches));
+                if (m_words[slot] == words)
+                    return m_indexes[slot];
+            }
+            if (empty_slots(group) != 0)
+                break;
+        }
+        return npos;
+    }
+
+    constexpr bool contains(const Key& symbol) const noexcept { return find(symbol) != npos; }
+
+    // index of the symbol, inserted if not found, npos if the table is full
+    constexpr index_type insert(const Key& symbol) noexcept
+    {
+        const auto words = words_of(symbol);
+        const auto h = hash(words);
+        const auto tag = tag_of(h);
+        size_t length = 1;
+        for (size_t probe = 0, group = h & (group_count - 1); probe < group_count; group = (group + ++probe) & (group_count - 1), ++length)
+        {
+            for (auto matches = match(group, tag); matches != 0; matches &= matches - 1)
+            {
+                const auto slot = group * detail_symbol::group_size + static_cast<size_t>(std::countr_zero(matches));
+                if (m_words[slot] == words)
+                    return m_indexes[slot];
+            }
+            if (const auto empties = empty_slots(group); empties != 0)
+            {
+                if (m_size == Capacity)
+                    return npos;
+                const auto slot = group * detail_symbol::group_size + static_cast<size_t>(std::countr_zero(empties));
+                const auto index = static_cast<index_type>(m_size++);
+                m_control[slot] = tag;
+                m_words[slot] = words;
+                m_indexes[slot] = index;
+                m_symbols[index] = symbol;
+                m_max_probe_length = std::max(m_max_probe_length, length);
+                return index;
+            }
+        }
+        return npos;
+    }
+
+    // symbol of an index (< size())
+    constexpr const Key& symbol(index_type index) const noexcept { return m_symbols[index]; }
+
+    constexpr size_t size() const noexcept { return m_size; }
+    constexpr bool empty() const noexcept { return m_size == 0; }
+    constexpr uint64_t seed() const noexcept { return m_seed; }
+
+    // largest number of groups probed to find a symbol of the table
+    constexpr size_t max_probe_length() const noexcept { return m_max_probe_length; }
+
+    constexpr void clear() noexcept
+    {
+        m_control.fill(detail_symbol::empty);
+        m_size = 0;
+        m_max_probe_length = 0;
+    }
+
+private:
+    // characters up to the first zero, as little endian words
+    constexpr static words_type words_of(const Key& symbol) noexcept
+    {
+        words_type words = {};
+        if (std::is_constant_evaluated())
+        {
+            for (size_t i = 0; i < Key::size && symbol.elems[i] != 0; ++i)
+                words[i / 8] |= uint64_t{ static_cast<uint8_t>(symbol.elems[i]) } << (i % 8 * 8);
+            return words;
+        }
+        std::memcpy(words.data(), symbol.elems, Key::size);
+        for (size_t i = 0; i < word_count; ++i)
+        {
+            if constexpr (std::endian::native == std::endian::big)
+                words[i] = bswap(words[i]);
+            if (const auto zeros = detail_simd::swar_zero_bytes(words[i]); zeros != 0)  // the lowest bit is exact
+            {
+                words[i] &= (uint64_t{ 1 } << (detail_simd::mask_index(zeros) & ~size_t{ 7 })) - 1;
+                for (size_t j = i + 1; j < word_count; ++j)
+                    words[j] = 0;
+                break;
+            }
+        }
+        return words;
+    }
+
+    constexpr uint64_t hash(const words_type& words) const noexcept
+    {
+        uint64_t h = words[0] ^ m_seed;
+        if constexpr (word_count == 2)
+            h = detail_symbol::mix(h) ^ std::rotl(words[1], 29);
+        return detail_symbol::mix(h);
+    }
+
+    constexpr static uint8_t tag_of(uint64_t h) noexcept
+    {
+        return static_cast<uint8_t>(h >> 57);  // 7 bits, never empty
+    }
+
+    constexpr uint32_t match(size_t group, uint8_t tag) const noexcept
+    {
+        const auto control = m_control.data() + group * detail_symbol::group_size;
+        if (!std::is_constant_evaluated())
+            return detail_simd::match_byte16(reinterpret_cast<const std::byte*>(control), tag);
+        uint32_t mask = 0;
+        for (size_t i = 0; i < detail_symbol::group_size; ++i)
+            mask |= static_cast<uint32_t>(control[i] == tag) << i;
+        return mask;
+    }
+
+    constexpr uint32_t empty_slots(size_t group) const noexcept
+    {
+        const auto control = m_control.data() + group * detail_symbol::group_size;
+        if (!std::is_constant_evaluated())
+            return detail_simd::high_bits16(reinterpret_cast<const std::byte*>(control));
+        uint32_t mask = 0;
+        for (size_t i = 0; i < detail_symbol::group_size; ++i)
+            mask |= static_cast<uint32_t>(control[i] >> 7) << i;
+        return mask;
+    }
+
+    constexpr void rebuild(std::span<const Key> symbols, uint64_t seed) noexcept
+    {
+        clear();
+        m_seed = seed;
+        for (const auto& symbol : symbols)
+            insert(symbol);
+    }
+
+    std::array<uint8_t, slot_count> m_control = {};
+    std::array<words_type, slot_count> m_words = {};
+    std::array<index_type, slot_count> m_indexes = {};
+    std::array<Key, Capacity> m_symbols = {};
+    size_t m_size = 0;
+    size_t m_max_probe_length = 0;
+    uint64_t m_seed = 0;
+};
+
+}  // namespace openmsg
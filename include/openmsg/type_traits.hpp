@@ -14,6 +14,7 @@
 #endif
 
 #include <bit>
+#include <cstddef>
 #include <inttypes.h>
 #include <type_traits>
 
@@ -33,4 +34,10 @@ requires (sizeof(T) <= 8 && std::has_single_bit(sizeof(T)))
 using as_half_size_t =  std::conditional_t<sizeof(T) == 8, uint32_t,
                         std::conditional_t<sizeof(T) == 4, uint16_t, uint8_t>>;
 
+template<size_t Size>
+requires (Size <= 8 && std::has_single_bit(Size))
+using uint_of_size_t =  std::conditional_t<Size == 8, uint64_t,
+                        std::conditional_t<Size == 4, uint32_t,
+                        std::conditional_t<Size == 2, uint16_t, uint8_t>>>;
+
 }  // namespace openmsg
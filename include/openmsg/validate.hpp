@@ -0,0 +1,166 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/bitfield.hpp"
+#include "openmsg/concepts.hpp"
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/reflection.hpp"
+#include "openmsg/type_traits.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <inttypes.h>
+#include <span>
+#include <type_traits>
+
+namespace openmsg {
+
+// Validation of the fields of a reflectable message (see reflection.hpp) against their
+// attributes: a value is valid if it is in [minValue, maxValue], or is the nullValue of an
+// optional field. Enums registered with OPENMSG_ENUM_VALUES are checked against their valid
+// enumerators instead of the range:
+//
+//     enum class Side : char { Buy = '1', Sell = '2' };
+//     OPENMSG_ENUM_VALUES(Side, Side::Buy, Side::Sell)
+//
+//     auto violations = validate(msg);  // bit i set if field i is invalid
+//
+// A BitPack is invalid if any of its bit fields is, an array if any of its values is, a
+// reflectable member if any of its fields is, other members (e.g. ArrayChar) are not
+// checked. Checks are branch-free, and the batch form checks one field of every message
+// at a time.
+
+using violations_t = uint64_t;  // bit i for field i
+
+template<auto... values>
+requires (sizeof...(values) > 0 && (enumerated<decltype(values)> && ...))
+struct EnumValues
+{
+    using value_type = std::common_type_t<decltype(values)...>;
+
+    constexpr static bool contains(value_type value) noexcept
+    {
+        return ((value == values) | ...);
+    }
+};
+
+template<typename E> concept has_enum_values = enumerated<E> && requires(E e) { openmsg_enum_values(e); };
+
+template<has_enum_values E> using enum_values_t = decltype(openmsg_enum_values(E{}));
+
+namespace detail_validate {
+
+template<endian_wrapper W>
+constexpr bool is_valid_value(const W& wrapper) noexcept
+{
+    using T = typename W::value_type;
+    const T value = wrapper();
+    bool valid;
+    if constexpr (has_enum_values<T>)
+        valid = enum_values_t<T>::contains(value);
+    else if constexpr (enumerated<T>)
+    {
+        using U = std::underlying_type_t<T>;
+        valid = (static_cast<U>(W::minValue) <= static_cast<U>(value)) & (static_cast<U>(value) <= static_cast<U>(W::maxValue));
+    }
+    else
+        valid = (W::minValue <= value) & (value <= W::maxValue);
+    if constexpr (W::is_optional)
+    {
+        using U = as_uint_type_t<T>;
+        valid |= std::bit_cast<U>(value) == std::bit_cast<U>(W::nullValue);
+    }
+    return valid;
+}
+
+template<typename T>
+constexpr bool is_valid_member(const T& member) noexcept;
+
+template<typename Msg>
+constexpr violations_t violations(const Msg& msg) noexcept
+{
+    static_assert(field_count<Msg> <= 64, "at most 64 fields can be validated");
+    violations_t mask = 0;
+    size_t i = 0;
+    for_each_field<Msg>([&](auto field)
+    {
+        mask |= static_cast<violations_t>(!is_valid_member(decltype(field)::get(msg))) << i++;
+    });
+    return mask;
+}
+
+template<typename T>
+constexpr bool is_valid_member(const T& member) noexcept
+{
+    if constexpr (endian_wrapper<T>)
+        return is_valid_value(member);
+    else if constexpr (bit_pack<T>)
+        return member.in_bound();
+    else if constexpr (std::is_array_v<T>)
+    {
+        bool valid = true;
+        for (const auto& element : member)
+            valid &= is_valid_member(element);
+        return valid;
+    }
+    else if constexpr (reflectable<T>)
+        return violations(member) == 0;
+    else
+        return true;
+}
+
+}  // namespace detail_validate
+
+// fields of a message violating their attributes, bit i set if field i is invalid
+
+template<reflectable Msg>
+constexpr violations_t validate(const Msg& msg) noexcept
+{
+    return detail_validate::violations(msg);
+}
+
+template<reflectable Msg>
+constexpr bool is_valid(const Msg& msg) noexcept
+{
+    return validate(msg) == 0;
+}
+
+// violations of contiguous messages, returns the number of invalid messages (up to the
+// smaller of the two sizes)
+
+template<reflectable Msg>
+constexpr size_t validate(std::span<const Msg> msgs, std::span<violations_t> violations) noexcept
+{
+    static_assert(field_count<Msg> <= 64, "at most 64 fields can be validated");
+    const auto n = std::min(msgs.size(), violations.size());
+    std::fill_n(violations.begin(), n, violations_t{ 0 });
+    size_t i = 0;
+    for_each_field<Msg>([&](auto field)
+    {
+        using F = decltype(field);
+        const auto bit = i++;
+        for (size_t j = 0; j < n; ++j)
+            violations[j] |= static_cast<violations_t>(!detail_validate::is_valid_member(F::get(msgs[j]))) << bit;
+    });
+    return static_cast<size_t>(std::count_if(violations.begin(), violations.begin() + static_cast<ptrdiff_t>(n), [](violations_t v) { return v != 0; }));
+}
+
+}  // namespace openmsg
+
+// registration of the valid enumerators of an enum E (next to E, found by ADL)
+
+#define OPENMSG_ENUM_VALUES(E, ...) \
+    [[maybe_unused]] ::openmsg::EnumValues<__VA_ARGS__> openmsg_enum_values(E) noexcept;
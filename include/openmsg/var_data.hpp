@@ -0,0 +1,148 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+#pragma once
+
+#if (__cplusplus < 202002L) && !defined(_HAS_CXX20)
+#error C++20 or more is needed
+#endif
+
+#include "openmsg/attributes.hpp"
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/type.hpp"
+#include "openmsg/type_traits.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+#include <span>
+#include <string_view>
+
+namespace openmsg {
+
+// Simple Binary Encoding (SBE) variable length data (varStringEncoding, varDataEncoding):
+// a length (LengthWrapper, e.g. LittleEndian<uint16_t>) followed by the data. The length
+// maxValue attribute is the maximum length accepted by the decoder and the encoder.
+//
+// VarData is a view over a buffer, and does not copy the data. Like ArrayCharacter,
+// VarData does not deal with endianess of the data intentionally.
+
+template<endian_wrapper LengthWrapper, typename T = char>
+requires any_integral<typename LengthWrapper::value_type> && (sizeof(T) == 1) && is_any_of<T, char, char8_t>
+class VarData
+{
+public:
+    using length_type = LengthWrapper;
+    using value_type = T;
+    constexpr static size_t max_length = LengthWrapper::maxValue;
+
+    constexpr VarData() noexcept = default;
+
+    explicit VarData(std::span<const std::byte> buffer) noexcept
+    {
+        if (buffer.size() < sizeof(LengthWrapper))
+            return;
+        LengthWrapper length;
+        std::memcpy(&length, buffer.data(), sizeof(LengthWrapper));
+        const size_t n = length();
+        if (n > max_length || buffer.size() - sizeof(LengthWrapper) < n)
+            return;
+        m_data = buffer.data() + sizeof(LengthWrapper);
+        m_size = n;
+        m_tail = buffer.subspan(sizeof(LengthWrapper) + n);
+        m_valid = true;
+    }
+
+    // false if the buffer is too small for the length or the data, the view is then empty
+    bool valid() const noexcept { return m_valid; }
+    explicit operator bool() const noexcept { return m_valid; }
+
+    // views
+
+    std::basic_string_view<value_type> operator()() const noexcept
+    {
+        return to_string_view();
+    }
+
+    std::basic_string_view<value_type> to_string_view() const noexcept
+    {
+        return { reinterpret_cast<const value_type*>(m_data), m_size };
+    }
+
+    std::span<const std::byte> bytes() const noexcept
+    {
+        return { m_data, m_size };
+    }
+
+    // misc
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    // length and data
+    size_t byte_size() const noexcept { return m_valid ? sizeof(LengthWrapper) + m_size : 0; }
+
+    // what follows the data (e.g. the next variable length data)
+    std::span<const std::byte> tail() const noexcept { return m_tail; }
+
+    // encoding
+
+    constexpr static size_t encoded_size(size_t length) noexcept
+    {
+        return sizeof(LengthWrapper) + length;
+    }
+
+    // writes at cursor, which must have encoded_size(value.size()) bytes available, with
+    // value.size() <= max_length, and returns the advanced cursor
+    static std::byte* encode(std::byte* cursor, std::span<const std::byte> value) noexcept
+    {
+        using length_value_type = typename LengthWrapper::value_type;
+        const LengthWrapper length(static_cast<length_value_type>(value.size()));
+        std::memcpy(cursor, &length, sizeof(LengthWrapper));
+        cursor += sizeof(LengthWrapper);
+        if (!value.empty())
+            std::memcpy(cursor, value.data(), value.size());
+        return cursor + value.size();
+    }
+
+    static std::byte* encode(std::byte* cursor, std::basic_string_view<value_type> value) noexcept
+    {
+        return encode(cursor, std::as_bytes(std::span(value)));
+    }
+
+    // writes at the beginning of buffer, and returns what follows the encoded data, or an
+    // empty span with a null data() if buffer is too small or value longer than max_length
+    static std::span<std::byte> encode(std::span<std::byte> buffer, std::span<const std::byte> value) noexcept
+    {
+        if (value.size() > max_length || buffer.size() < encoded_size(value.size()))
+            return {};
+        return buffer.subspan(static_cast<size_t>(encode(buffer.data(), value) - buffer.data()));
+    }
+
+    static std::span<std::byte> encode(std::span<std::byte> buffer, std::basic_string_view<value_type> value) noexcept
+    {
+        return encode(buffer, std::as_bytes(std::span(value)));
+    }
+
+private:
+    const std::byte* m_data = nullptr;
+    size_t m_size = 0;
+    std::span<const std::byte> m_tail;
+    bool m_valid = false;
+};
+
+// SBE standard encodings (length is a uint32 limited to 2^30)
+
+template<template<typename...> class _W = LittleEndian>
+using VarStringEncoding = VarData<_W<Type<uint32_t, Attributes<uint32_t, Presence::required, bounds<uint32_t>::nullValue, 0, 1073741824>>>, char>;
+
+template<template<typename...> class _W = LittleEndian>
+using VarDataEncoding = VarStringEncoding<_W>;
+
+}  // namespace openmsg
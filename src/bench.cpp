@@ -0,0 +1,325 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+// Microbenchmarks of the memory wrappers, written as JSON on stdout:
+//
+//     bench [--min-time-ms N] [--filter text]
+//
+// Each case decodes (mtoh) or encodes (htom) fields of every swappable type (enums
+// use their underlying type), for both endiannesses, aligned or misaligned (offset
+// of 1 byte), and with the following accesses:
+// - single: the same field, reloaded at each access
+// - array:  an array of fields, one EndianWrapper access per field
+// - bulk:   an array of fields, using mtoh/htom of bulk.hpp (memory_wrapper_bswap only)
+//
+// The best time of the batches run during min-time-ms is reported as ns/field and GB/s
+// (wire bytes).
+
+#include "openmsg/bulk.hpp"
+#include "openmsg/endian_wrapper.hpp"
+#include "openmsg/memory_wrapper.hpp"
+#include "openmsg/simd.hpp"
+
+#include "inttypes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openmsg::bench {
+
+constexpr size_t fields_per_batch = 4096;  // fits in L1/L2 for all the types
+
+struct Options
+{
+    std::chrono::nanoseconds min_time = std::chrono::milliseconds(10);
+    std::string filter;
+};
+
+// optimisation barriers
+
+template<typename T>
+inline void do_not_optimize(const T& value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+inline void clobber_memory() noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// names
+
+template<typename T> constexpr std::string_view type_name = "";
+template<> constexpr std::string_view type_name<char8_t> = "char8_t";
+template<> constexpr std::string_view type_name<int8_t> = "int8_t";
+template<> constexpr std::string_view type_name<uint8_t> = "uint8_t";
+template<> constexpr std::string_view type_name<int16_t> = "int16_t";
+template<> constexpr std::string_view type_name<uint16_t> = "uint16_t";
+template<> constexpr std::string_view type_name<int32_t> = "int32_t";
+template<> constexpr std::string_view type_name<uint32_t> = "uint32_t";
+template<> constexpr std::string_view type_name<int64_t> = "int64_t";
+template<> constexpr std::string_view type_name<uint64_t> = "uint64_t";
+template<> constexpr std::string_view type_name<float> = "float";
+template<> constexpr std::string_view type_name<double> = "double";
+
+template<template<typename H, std::endian> class MW> constexpr std::string_view wrapper_name = "";
+template<> constexpr std::string_view wrapper_name<memory_wrapper_bswap> = "bswap";
+template<> constexpr std::string_view wrapper_name<memory_wrapper_robust> = "robust";
+template<> constexpr std::string_view wrapper_name<memory_wrapper_movbe> = "movbe";
+
+struct Case
+{
+    std::string_view type;
+    std::string_view endian;
+    std::string_view wrapper;
+    std::string_view alignment;
+    std::string_view access;
+    std::string_view operation;
+
+    std::string name() const
+    {
+        std::string s;
+        for (auto part : { type, endian, wrapper, alignment, access, operation })
+            s.append(s.empty() ? "" : "/").append(part);
+        return s;
+    }
+};
+
+class Report
+{
+public:
+    explicit Report(const Options& options)
+        : m_options(options)
+    {
+        std::cout << "{\n  \"library\": \"openmsg\",\n  \"compiler\": \"" << compiler() << "\",\n  \"simd\": \"" << simd() << "\",\n";
+        std::cout << "  \"fields_per_batch\": " << fields_per_batch << ",\n";
+        std::cout << "  \"min_time_ms\": " << std::chrono::duration_cast<std::chrono::milliseconds>(options.min_time).count() << ",\n";
+        std::cout << "  \"results\": [";
+    }
+
+    ~Report()
+    {
+        std::cout << (m_count ? "\n  ]\n}\n" : "]\n}\n");
+    }
+
+    // runs batch (which processes fields_per_batch fields) until min_time elapsed, keeps the best time
+    template<typename Batch>
+    void run(const Case& c, size_t field_size, Batch&& batch)
+    {
+        if (!m_options.filter.empty() && c.name().find(m_options.filter) == std::string::npos)
+            return;
+        using clock = std::chrono::steady_clock;
+        batch();  // warm up
+        auto best = std::chrono::nanoseconds::max();
+        std::chrono::nanoseconds total{};
+        size_t batches = 0;
+        while (total < m_options.min_time || batches < 3)
+        {
+            const auto start = clock::now();
+            batch();
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+            best = std::min(best, elapsed);
+            total += elapsed;
+            ++batches;
+        }
+        const auto ns = static_cast<double>(best.count());
+        const auto ns_per_field = ns / static_cast<double>(fields_per_batch);
+        const auto gb_per_s = static_cast<double>(field_size * fields_per_batch) / ns;  // bytes per ns
+
+        std::cout << (m_count++ ? ",\n" : "\n") << "    { ";
+        std::cout << "\"type\": \"" << c.type << "\", \"endian\": \"" << c.endian << "\", \"wrapper\": \"" << c.wrapper
+                  << "\", \"alignment\": \"" << c.alignment << "\", \"access\": \"" << c.access << "\", \"operation\": \"" << c.operation << "\", ";
+        std::cout << std::fixed << std::setprecision(4) << "\"ns_per_field\": " << ns_per_field << ", \"gb_per_s\": " << gb_per_s;
+        std::cout << std::defaultfloat << ", \"batches\": " << batches << " }";
+    }
+
+private:
+    static std::string_view compiler()
+    {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc";
+#else
+        return "unknown";
+#endif
+    }
+
+    static std::string_view simd()
+    {
+#if defined(OPENMSG_SIMD_AVX2)
+        return "avx2";
+#elif defined(OPENMSG_SIMD_SSSE3)
+        return "ssse3";
+#elif defined(OPENMSG_SIMD_SSE2)
+        return "sse2";
+#else
+        return "none";
+#endif
+    }
+
+    const Options& m_options;
+    size_t m_count = 0;
+};
+
+template<swappable T>
+T make_value(size_t i) noexcept
+{
+    if constexpr (std::is_floating_point_v<T>)
+        return static_cast<T>(static_cast<int>(i % 1000) - 500) / static_cast<T>(8);
+    else
+        return static_cast<T>(i * 0x9E3779B97F4A7C15ull >> 7);
+}
+
+// fields_per_batch wire fields at an offset of a byte buffer
+template<typename W>
+class WireBuffer
+{
+public:
+    explicit WireBuffer(size_t offset)
+        : m_buffer(offset + fields_per_batch * sizeof(W))
+    {
+        m_fields = reinterpret_cast<W*>(m_buffer.data() + offset);  // W is packed
+        for (size_t i = 0; i < fields_per_batch; ++i)
+            new (m_fields + i) W(make_value<typename W::value_type>(i));
+    }
+
+    std::span<W> fields() noexcept { return { m_fields, fields_per_batch }; }
+
+private:
+    std::vector<std::byte> m_buffer;
+    W* m_fields = nullptr;
+};
+
+template<typename T, std::endian endian, template<typename H, std::endian> class MW>
+void bench_wrapper(Report& report, std::string_view alignment, size_t offset)
+{
+    using W = EndianWrapper<T, endian, MW>;
+    const auto endian_name = endian == std::endian::little ? "little" : "big";
+    const auto wrapper = wrapper_name<MW>;
+    WireBuffer<W> wire(offset);
+    auto fields = wire.fields();
+    std::vector<T> host(fields_per_batch);
+    for (size_t i = 0; i < host.size(); ++i)
+        host[i] = make_value<T>(i);
+
+    report.run({ type_name<T>, endian_name, wrapper, alignment, "single", "decode" }, sizeof(T), [&]
+    {
+        for (size_t i = 0; i < fields_per_batch; ++i)
+        {
+            auto value = fields[0]();
+            do_not_optimize(value);
+            clobber_memory();
+        }
+    });
+    report.run({ type_name<T>, endian_name, wrapper, alignment, "single", "encode" }, sizeof(T), [&]
+    {
+        for (size_t i = 0; i < fields_per_batch; ++i)
+        {
+            fields[0] = host[i];
+            clobber_memory();
+        }
+    });
+    report.run({ type_name<T>, endian_name, wrapper, alignment, "array", "decode" }, sizeof(T), [&]
+    {
+        for (size_t i = 0; i < fields_per_batch; ++i)
+            host[i] = fields[i]();
+        do_not_optimize(host.data());
+        clobber_memory();
+    });
+    report.run({ type_name<T>, endian_name, wrapper, alignment, "array", "encode" }, sizeof(T), [&]
+    {
+        for (size_t i = 0; i < fields_per_batch; ++i)
+            fields[i] = host[i];
+        do_not_optimize(fields.data());
+        clobber_memory();
+    });
+
+    if constexpr (std::is_same_v<MW<T, endian>, memory_wrapper_bswap<T, endian>>)
+    {
+        report.run({ type_name<T>, endian_name, wrapper, alignment, "bulk", "decode" }, sizeof(T), [&]
+        {
+            mtoh(std::span<const W>(fields), std::span<T>(host));
+            do_not_optimize(host.data());
+            clobber_memory();
+        });
+        report.run({ type_name<T>, endian_name, wrapper, alignment, "bulk", "encode" }, sizeof(T), [&]
+        {
+            htom(std::span<const T>(host), fields, StoreHint::temporal);
+            do_not_optimize(fields.data());
+            clobber_memory();
+        });
+    }
+}
+
+template<typename T, std::endian endian>
+void bench_endian(Report& report)
+{
+    for (auto [alignment, offset] : { std::pair<std::string_view, size_t>{ "aligned", 0 }, { "misaligned", 1 } })
+    {
+        bench_wrapper<T, endian, memory_wrapper_bswap>(report, alignment, offset);
+        bench_wrapper<T, endian, memory_wrapper_robust>(report, alignment, offset);
+        bench_wrapper<T, endian, memory_wrapper_movbe>(report, alignment, offset);
+    }
+}
+
+template<typename... Ts>
+void bench_types(Report& report)
+{
+    (bench_endian<Ts, std::endian::little>(report), ...);
+    (bench_endian<Ts, std::endian::big>(report), ...);
+}
+
+}  // namespace openmsg::bench
+
+int main(int argc, char* argv[])
+{
+    using namespace openmsg::bench;
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--min-time-ms" && i + 1 < argc)
+            options.min_time = std::chrono::milliseconds(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--filter" && i + 1 < argc)
+            options.filter = argv[++i];
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--min-time-ms N] [--filter text]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    Report report(options);
+    bench_types<char8_t, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t, float, double>(report);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+// Replay throughput of pcap.hpp, written as JSON on stdout:
+//
+//     bench_pcap [--min-time-ms N] [--packets N] [--file capture.pcap]
+//
+// Without --file, a synthetic capture is built in memory: Ethernet frames of UDP (IPv4)
+// and TCP (IPv6, VLAN tagged) packets with 64 to 320 bytes of payload. With --file, the
+// capture (pcap or pcapng) is memory mapped. Each case replays the whole capture:
+// - read:   records only (PcapReader::next)
+// - decode: records and their Ethernet/IP/UDP/TCP headers (Packet::layers)
+//
+// The best time of the replays run during min-time-ms is reported as packets/s and GB/s.
+
+#include "openmsg/mapped_file.hpp"
+#include "openmsg/net.hpp"
+#include "openmsg/pcap.hpp"
+
+#include "inttypes.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace openmsg::bench {
+
+struct Options
+{
+    std::chrono::nanoseconds min_time = std::chrono::milliseconds(200);
+    size_t packets = 100000;
+    const char* file = nullptr;
+};
+
+template<typename T>
+void append(std::vector<std::byte>& buf, const T& value, size_t size = sizeof(T))
+{
+    const auto at = buf.size();
+    buf.resize(at + size, std::byte{ 0 });
+    std::memcpy(buf.data() + at, &value, std::min(size, sizeof(T)));
+}
+
+// little endian pcap (ns resolution) of udp and tcp frames
+std::vector<std::byte> make_capture(size_t packets)
+{
+    using namespace net;
+    std::vector<std::byte> capture;
+    append(capture, PcapFileHeader<>{ detail_pcap::pcap_magic_ns, 2, 4, 0, 0, 65535, static_cast<uint32_t>(LinkType::ethernet) });
+    std::vector<std::byte> frame;
+    for (size_t i = 0; i < packets; ++i)
+    {
+        const bool tcp = i % 4 == 3;
+        const auto payload = static_cast<uint16_t>(64 + (i * 37) % 257);
+        frame.clear();
+        append(frame, EthernetHeader{ {}, {}, tcp ? EtherType::vlan : EtherType::ipv4 });
+        if (tcp)
+        {
+            append(frame, VlanTag{ 100, EtherType::ipv6 });
+            append(frame, Ipv6Header{ 0x60000000u, static_cast<uint16_t>(sizeof(TcpHeader) + payload), IpProtocol::tcp, 64, {}, {} });
+            append(frame, TcpHeader{ 1234, 80, static_cast<uint32_t>(i), 0, static_cast<uint16_t>((5 << 12) | TcpHeader::ack), 1024, 0, 0 });
+        }
+        else
+        {
+            append(frame, Ipv4Header{ 0x45, 0, static_cast<uint16_t>(sizeof(Ipv4Header) + sizeof(UdpHeader) + payload), 0, 0, 64, IpProtocol::udp, 0, 0x0A000001u, 0xE0000001u });
+            append(frame, UdpHeader{ 5000, 6000, static_cast<uint16_t>(sizeof(UdpHeader) + payload), 0 });
+        }
+        frame.resize(frame.size() + payload, std::byte{ 0x5A });
+        const auto timestamp = 1700000000000000000ull + i * 1000;
+        append(capture, PcapRecordHeader<>{ static_cast<uint32_t>(timestamp / 1000000000), static_cast<uint32_t>(timestamp % 1000000000),
+                                            static_cast<uint32_t>(frame.size()), static_cast<uint32_t>(frame.size()) });
+        capture.insert(capture.end(), frame.begin(), frame.end());
+    }
+    return capture;
+}
+
+// replays the capture until min_time elapsed, returns the best time
+template<typename Replay>
+std::chrono::nanoseconds run(const Options& options, Replay&& replay)
+{
+    using clock = std::chrono::steady_clock;
+    replay();  // warm up
+    auto best = std::chrono::nanoseconds::max();
+    std::chrono::nanoseconds total{};
+    for (size_t runs = 0; total < options.min_time || runs < 3; ++runs)
+    {
+        const auto start = clock::now();
+        replay();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+        best = std::min(best, elapsed);
+        total += elapsed;
+    }
+    return best;
+}
+
+void report(bool first, std::string_view access, size_t packets, size_t bytes, std::chrono::nanoseconds best)
+{
+    const auto ns = static_cast<double>(best.count());
+    std::cout << (first ? "\n" : ",\n") << "    { \"access\": \"" << access << "\", ";
+    std::cout << std::fixed << std::setprecision(0) << "\"packets_per_s\": " << static_cast<double>(packets) * 1e9 / ns << ", ";
+    std::cout << std::setprecision(4) << "\"gb_per_s\": " << static_cast<double>(bytes) / ns << ", \"ns_per_packet\": " << ns / static_cast<double>(packets);
+    std::cout << std::defaultfloat << " }";
+}
+
+}  // namespace openmsg::bench
+
+int main(int argc, char* argv[])
+{
+    using namespace openmsg;
+    using namespace openmsg::bench;
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--min-time-ms" && i + 1 < argc)
+            options.min_time = std::chrono::milliseconds(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--packets" && i + 1 < argc)
+            options.packets = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--file" && i + 1 < argc)
+            options.file = argv[++i];
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--min-time-ms N] [--packets N] [--file capture.pcap]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    MappedFile file;
+    std::vector<std::byte> synthetic;
+    std::span<const std::byte> capture;
+    if (options.file != nullptr)
+    {
+        if (!file.open(options.file))
+        {
+            std::cerr << "cannot open " << options.file << '\n';
+            return EXIT_FAILURE;
+        }
+        capture = file.data();
+    }
+    else
+    {
+        synthetic = make_capture(options.packets);
+        capture = synthetic;
+    }
+
+    net::PcapReader check(capture);
+    net::Packet batch[64];
+    size_t packets = 0;
+    while (size_t n = check.next(batch))
+        packets += n;
+    if (!check.valid() || packets == 0)
+    {
+        std::cerr << "invalid or empty capture\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "{\n  \"library\": \"openmsg\",\n  \"capture\": \"" << (options.file ? options.file : "synthetic") << "\",\n";
+    std::cout << "  \"packets\": " << packets << ",\n  \"bytes\": " << capture.size() << ",\n  \"results\": [";
+
+    volatile size_t sink = 0;
+    const auto read = run(options, [&]
+    {
+        net::PcapReader reader(capture);
+        size_t frame_bytes = 0;
+        while (size_t n = reader.next(batch))
+            for (const auto& packet : std::span(batch, n))
+                frame_bytes += packet.frame.size();
+        sink = sink + frame_bytes;
+    });
+    report(true, "read", packets, capture.size(), read);
+
+    const auto decode = run(options, [&]
+    {
+        net::PcapReader reader(capture);
+        size_t payload_bytes = 0;
+        while (size_t n = reader.next(batch))
+            for (const auto& packet : std::span(batch, n))
+                payload_bytes += packet.layers().payload.size();
+        sink = sink + payload_bytes;
+    });
+    report(false, "decode", packets, capture.size(), decode);
+
+    std::cout << "\n  ]\n}\n";
+    return EXIT_SUCCESS;
+}
@@ -9,6 +9,8 @@
 
 #include "openmsg/endian_wrapper.hpp"  // This is the bit to include when using BigEndian or LittleEndian wrappers
 #include "openmsg/array_char.hpp"      // This is the bit to include when using ArrayChar or ArrayChar8
+#include "openmsg/message_view.hpp"    // This is the bit to include when decoding from a buffer
+#include <cstring>
 #include <iostream>
 
 namespace openmsg {
@@ -51,6 +53,14 @@ void example()
         std::cout << values[p[i] >> 4] << values[p[i] & 0xF];
     // efbeadde
     std::cout << std::endl;
+
+    // decoding from a buffer (e.g. received from the network), with a single size check
+    std::byte buffer[sizeof(m)];
+    std::memcpy(buffer, &m, sizeof(m));
+    MessageView<example_message<>> view(buffer);
+    if (view)
+        std::cout << view.value<&example_message<>::a>() << " " << view.value<&example_message<>::c>(0) << std::endl;
+    // deadbeef deadbeef
 }
 
 }  // namespace openmsg
@@ -0,0 +1,1010 @@
+// openmsg by Sebastien Rubens
+//
+// To the extent possible under law, the person who associated CC0 with
+// openmsg has waived all copyright and related or neighboring rights
+// to openmsg.
+//
+// You should have received a copy of the CC0 legalcode along with this
+// work.  If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+
+// sbe_codegen generates a header of openmsg packed structures from a Simple Binary
+// Encoding (SBE) XML schema:
+//
+//     sbe_codegen schema.xml [output.hpp]
+//
+// Types are mapped to EndianWrapper (through a Wire alias using the schema byteOrder),
+// Optionull/Type with the schema null/min/max values, ArrayChar, GroupView/GroupCursor
+// and VarData (listed in wire order as Sections, for IndexedMessage). Constants are
+// constexpr static members, and the layout (offsets and sizes, including blockLength
+// padding) is checked with static_assert.
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sbe_codegen {
+
+// XML (subset needed by SBE schemas: elements, attributes, text, comments,
+// processing instructions, DOCTYPE and CDATA)
+
+struct XmlNode
+{
+    std::string name;  // without namespace prefix
+    std::vector<std::pair<std::string, std::string>> attributes;
+    std::vector<XmlNode> children;
+    std::string text;
+
+    const std::string* attribute(std::string_view key) const
+    {
+        for (const auto& [k, v] : attributes)
+            if (k == key)
+                return &v;
+        return nullptr;
+    }
+
+    std::string attribute_or(std::string_view key, std::string_view default_value) const
+    {
+        auto value = attribute(key);
+        return value ? *value : std::string(default_value);
+    }
+};
+
+class XmlParser
+{
+public:
+    explicit XmlParser(std::string_view src)
+        : m_src(src)
+    {
+    }
+
+    XmlNode parse()
+    {
+        skip_misc();
+        auto root = parse_element();
+        skip_misc();
+        if (m_pos != m_src.size())
+            error("unexpected content after the root element");
+        return root;
+    }
+
+private:
+    [[noreturn]] void error(const std::string& message) const
+    {
+        size_t line = 1;
+        for (size_t i = 0; i < m_pos && i < m_src.size(); ++i)
+            line += m_src[i] == '\n';
+        throw std::runtime_error("xml: line " + std::to_string(line) + ": " + message);
+    }
+
+    bool starts_with(std::string_view s) const
+    {
+        return m_src.substr(m_pos).starts_with(s);
+    }
+
+    void skip_until(std::string_view end)
+    {
+        auto i = m_src.find(end, m_pos);
+        if (i == std::string_view::npos)
+            error("missing " + std::string(end));
+        m_pos = i + end.size();
+    }
+
+    void skip_spaces()
+    {
+        while (m_pos < m_src.size() && std::isspace(static_cast<unsigned char>(m_src[m_pos])))
+            ++m_pos;
+    }
+
+    void skip_misc()
+    {
+        for (;;)
+        {
+            skip_spaces();
+            if (starts_with("<?"))
+                skip_until("?>");
+            else if (starts_with("<!--"))
+                skip_until("-->");
+            else if (starts_with("<!DOCTYPE"))
+                skip_until(">");
+            else
+                return;
+        }
+    }
+
+    static std::string strip_prefix(std::string_view name)
+    {
+        auto i = name.find(':');
+        return std::string(i == std::string_view::npos ? name : name.substr(i + 1));
+    }
+
+    std::string parse_name()
+    {
+        auto start = m_pos;
+        while (m_pos < m_src.size() && (std::isalnum(static_cast<unsigned char>(m_src[m_pos])) || std::string_view("_:-.").find(m_src[m_pos]) != std::string_view::npos))
+            ++m_pos;
+        if (start == m_pos)
+            error("name expected");
+        return std::string(m_src.substr(start, m_pos - start));
+    }
+
+    std::string decode(std::string_view s) const
+    {
+        std::string out;
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            if (s[i] != '&')
+            {
+                out += s[i];
+                continue;
+            }
+            auto end = s.find(';', i);
+            if (end == std::string_view::npos)
+                error("unterminated entity");
+            auto entity = s.substr(i + 1, end - i - 1);
+            if (entity == "lt") out += '<';
+            else if (entity == "gt") out += '>';
+            else if (entity == "amp") out += '&';
+            else if (entity == "quot") out += '"';
+            else if (entity == "apos") out += '\'';
+            else if (entity.starts_with("#x")) out += static_cast<char>(std::stoi(std::string(entity.substr(2)), nullptr, 16));
+            else if (entity.starts_with("#")) out += static_cast<char>(std::stoi(std::string(entity.substr(1))));
+            else error("unknown entity &" + std::string(entity) + ";");
+            i = end;
+        }
+        return out;
+    }
+
+    XmlNode parse_element()
+    {
+        if (!starts_with("<"))
+            error("element expected");
+        ++m_pos;
+        XmlNode node;
+        const auto qualified_name = parse_name();
+        node.name = strip_prefix(qualified_name);
+        for (;;)
+        {
+            skip_spaces();
+            if (starts_with("/>"))
+            {
+                m_pos += 2;
+                return node;
+            }
+            if (starts_with(">"))
+            {
+                ++m_pos;
+                break;
+            }
+            auto key = parse_name();
+            skip_spaces();
+            if (!starts_with("="))
+                error("= expected after attribute " + key);
+            ++m_pos;
+            skip_spaces();
+            if (m_pos >= m_src.size() || (m_src[m_pos] != '"' && m_src[m_pos] != '\''))
+                error("quoted value expected for attribute " + key);
+            const char quote = m_src[m_pos++];
+            auto end = m_src.find(quote, m_pos);
+            if (end == std::string_view::npos)
+                error("unterminated value for attribute " + key);
+            node.attributes.emplace_back(key, decode(m_src.substr(m_pos, end - m_pos)));
+            m_pos = end + 1;
+        }
+        for (;;)
+        {
+            if (m_pos >= m_src.size())
+                error("missing </" + qualified_name + ">");
+            if (starts_with("</"))
+            {
+                m_pos += 2;
+                if (parse_name() != qualified_name)
+                    error("mismatched </" + qualified_name + ">");
+                skip_spaces();
+                if (!starts_with(">"))
+                    error("> expected");
+                ++m_pos;
+                return node;
+            }
+            if (starts_with("<!--"))
+                skip_until("-->");
+            else if (starts_with("<?"))
+                skip_until("?>");
+            else if (starts_with("<![CDATA["))
+            {
+                auto start = m_pos + 9;
+                skip_until("]]>");
+                node.text += m_src.substr(start, m_pos - 3 - start);
+            }
+            else if (starts_with("<"))
+                node.children.push_back(parse_element());
+            else
+            {
+                auto end = m_src.find('<', m_pos);
+                if (end == std::string_view::npos)
+                    end = m_src.size();
+                node.text += decode(m_src.substr(m_pos, end - m_pos));
+                m_pos = end;
+            }
+        }
+    }
+
+    std::string_view m_src;
+    size_t m_pos = 0;
+};
+
+// SBE model
+
+struct Primitive
+{
+    std::string_view sbe_name;
+    std::string_view cpp_name;
+    size_t size;
+    bool is_char;
+    bool is_signed;
+    bool is_float;
+};
+
+constexpr Primitive primitives[] = {
+    { "char",   "char",     1, true,  false, false },
+    { "int8",   "int8_t",   1, false, true,  false },
+    { "uint8",  "uint8_t",  1, false, false, false },
+    { "int16",  "int16_t",  2, false, true,  false },
+    { "uint16", "uint16_t", 2, false, false, false },
+    { "int32",  "int32_t",  4, false, true,  false },
+    { "uint32", "uint32_t", 4, false, false, false },
+    { "int64",  "int64_t",  8, false, true,  false },
+    { "uint64", "uint64_t", 8, false, false, false },
+    { "float",  "float",    4, false, true,  true  },
+    { "double", "double",   8, false, true,  true  },
+};
+
+const Primitive* find_primitive(std::string_view name)
+{
+    for (const auto& primitive : primitives)
+        if (primitive.sbe_name == name)
+            return &primitive;
+    return nullptr;
+}
+
+enum class Kind
+{
+    primitive,
+    composite,
+    enumeration,
+    set,
+};
+
+struct Type;
+
+struct Member
+{
+    std::string name;
+    std::shared_ptr<const Type> type;
+    std::string presence;  // empty if not overridden
+    std::string value_ref;
+    std::string description;
+    long offset = -1;
+};
+
+struct Type
+{
+    Kind kind = Kind::primitive;
+    std::string name;
+    std::string description;
+    const Primitive* primitive = nullptr;  // primitive type, or encoding type of enum and set
+    size_t length = 1;
+    std::string presence = "required";
+    std::string null_value;
+    std::string min_value;
+    std::string max_value;
+    std::string constant;
+    std::vector<Member> members;  // composite
+    std::vector<std::pair<std::string, std::string>> values;  // enum valid values, set choices
+    bool is_named = false;  // declared in <types> (an alias is generated)
+
+    bool is_constant() const { return presence == "constant"; }
+
+    // composite such as varStringEncoding (length followed by a varData of length 0)
+    bool is_var_data() const
+    {
+        return kind == Kind::composite && members.size() == 2 && members[1].type->kind == Kind::primitive && members[1].type->length == 0;
+    }
+
+    size_t size() const
+    {
+        switch (kind)
+        {
+        case Kind::primitive:
+            return is_constant() ? 0 : primitive->size * length;
+        case Kind::enumeration:
+        case Kind::set:
+            return primitive->size;
+        case Kind::composite:
+        {
+            size_t size = 0;
+            for (const auto& member : members)
+                size = std::max(size, static_cast<size_t>(std::max(0l, member.offset))) + member.type->size();
+            return size;
+        }
+        default:
+            return 0;
+        }
+    }
+};
+
+struct Field
+{
+    enum class Section
+    {
+        field,
+        group,
+        data,
+    };
+
+    Section section = Section::field;
+    std::string name;
+    std::string description;
+    std::shared_ptr<const Type> type;   // field, data
+    std::string presence;
+    std::string value_ref;
+    long offset = -1;
+
+    // group
+    std::shared_ptr<const Type> dimension;
+    long block_length = -1;
+    std::vector<Field> fields;
+
+    bool has_variable_sections() const
+    {
+        for (const auto& field : fields)
+            if (field.section != Section::field)
+                return true;
+        return false;
+    }
+};
+
+struct Message
+{
+    std::string name;
+    std::string description;
+    std::string id;
+    long block_length = -1;
+    std::vector<Field> fields;
+};
+
+// Schema
+
+class Schema
+{
+public:
+    explicit Schema(const XmlNode& root)
+    {
+        if (root.name != "messageSchema")
+            throw std::runtime_error("messageSchema root element expected");
+        package = root.attribute_or("package", "");
+        id = root.attribute_or("id", "0");
+        version = root.attribute_or("version", "0");
+        byte_order = root.attribute_or("byteOrder", "littleEndian");
+        header_type = root.attribute_or("headerType", "messageHeader");
+        description = root.attribute_or("description", "");
+        if (byte_order != "littleEndian" && byte_order != "bigEndian")
+            throw std::runtime_error("unknown byteOrder " + byte_order);
+
+        for (const auto& child : root.children)
+            if (child.name == "types")
+                for (const auto& node : child.children)
+                    m_type_nodes.emplace(node.attribute_or("name", ""), &node);
+        for (const auto& child : root.children)
+            if (child.name == "types")
+                for (const auto& node : child.children)
+                    resolve(node.attribute_or("name", ""));
+        for (const auto& child : root.children)
+            if (child.name == "message")
+                messages.push_back(parse_message(child));
+    }
+
+    std::string package;
+    std::string id;
+    std::string version;
+    std::string byte_order;
+    std::string header_type;
+    std::string description;
+    std::vector<std::shared_ptr<const Type>> types;  // in dependency order
+    std::vector<Message> messages;
+
+    std::shared_ptr<const Type> resolve(const std::string& name)
+    {
+        if (auto it = m_types.find(name); it != m_types.end())
+        {
+            if (!it->second)
+                throw std::runtime_error("recursive type " + name);
+            return it->second;
+        }
+        if (auto primitive = find_primitive(name))
+        {
+            auto type = std::make_shared<Type>();
+            type->name = name;
+            type->primitive = primitive;
+            return type;
+        }
+        auto node = m_type_nodes.find(name);
+        if (node == m_type_nodes.end())
+            throw std::runtime_error("unknown type " + name);
+        m_types[name] = nullptr;  // detects recursion
+        auto type = parse_type(*node->second);
+        type->is_named = true;
+        m_types[name] = type;
+        types.push_back(type);
+        return type;
+    }
+
+private:
+    static long to_long(const XmlNode& node, std::string_view key, long default_value)
+    {
+        auto value = node.attribute(key);
+        return value ? std::stol(*value) : default_value;
+    }
+
+    std::shared_ptr<Type> parse_type(const XmlNode& node)
+    {
+        auto type = std::make_shared<Type>();
+        type->name = node.attribute_or("name", "");
+        type->description = node.attribute_or("description", "");
+        type->presence = node.attribute_or("presence", "required");
+        if (node.name == "type")
+        {
+            type->kind = Kind::primitive;
+            type->primitive = find_primitive(node.attribute_or("primitiveType", ""));
+            if (!type->primitive)
+                throw std::runtime_error("unknown primitiveType for type " + type->name);
+            type->length = static_cast<size_t>(to_long(node, "length", 1));
+            type->null_value = node.attribute_or("nullValue", "");
+            type->min_value = node.attribute_or("minValue", "");
+            type->max_value = node.attribute_or("maxValue", "");
+            type->constant = trim(node.text);
+            if (type->is_constant() && type->primitive->is_char && type->length == 1 && type->constant.size() > 1)
+                type->length = type->constant.size();
+        }
+        else if (node.name == "enum" || node.name == "set")
+        {
+            type->kind = node.name == "enum" ? Kind::enumeration : Kind::set;
+            auto encoding = node.attribute_or("encodingType", "");
+            type->primitive = find_primitive(encoding);
+            if (!type->primitive)  // encodingType may be a named type
+                type->primitive = resolve(encoding)->primitive;
+            for (const auto& value : node.children)
+                type->values.emplace_back(value.attribute_or("name", ""), trim(value.text));
+        }
+        else if (node.name == "composite")
+        {
+            type->kind = Kind::composite;
+            for (const auto& child : node.children)
+            {
+                Member member;
+                member.name = child.attribute_or("name", "");
+                member.description = child.attribute_or("description", "");
+                member.offset = to_long(child, "offset", -1);
+                if (child.name == "ref")
+                {
+                    member.type = resolve(child.attribute_or("type", ""));
+                    member.presence = child.attribute_or("presence", "");
+                }
+                else
+                {
+                    auto inner = parse_type(child);
+                    if (inner->kind != Kind::primitive)  // inline enum, set or composite, declared as a named type
+                    {
+                        if (m_types.contains(inner->name))
+                            throw std::runtime_error("duplicate type " + inner->name);
+                        inner->is_named = true;
+                        m_types[inner->name] = inner;
+                        types.push_back(inner);
+                    }
+                    member.type = inner;
+                }
+                type->members.push_back(member);
+            }
+        }
+        else
+            throw std::runtime_error("unknown type element " + node.name);
+        return type;
+    }
+
+    std::vector<Field> parse_fields(const XmlNode& node)
+    {
+        std::vector<Field> fields;
+        for (const auto& child : node.children)
+        {
+            Field field;
+            field.name = child.attribute_or("name", "");
+            field.description = child.attribute_or("description", "");
+            if (child.name == "field" || child.name == "data")
+            {
+                field.section = child.name == "field" ? Field::Section::field : Field::Section::data;
+                field.type = resolve(child.attribute_or("type", ""));
+                field.presence = child.attribute_or("presence", "");
+                field.value_ref = child.attribute_or("valueRef", "");
+                field.offset = to_long(child, "offset", -1);
+                if (field.section == Field::Section::data && !field.type->is_var_data())
+                    throw std::runtime_error("data " + field.name + " must use a variable length composite");
+            }
+            else if (child.name == "group")
+            {
+                field.section = Field::Section::group;
+                field.dimension = resolve(child.attribute_or("dimensionType", "groupSizeEncoding"));
+                field.block_length = to_long(child, "blockLength", -1);
+                field.fields = parse_fields(child);
+            }
+            else
+                continue;
+            fields.push_back(field);
+        }
+        return fields;
+    }
+
+    Message parse_message(const XmlNode& node)
+    {
+        Message message;
+        message.name = node.attribute_or("name", "");
+        message.description = node.attribute_or("description", "");
+        message.id = node.attribute_or("id", "0");
+        message.block_length = to_long(node, "blockLength", -1);
+        message.fields = parse_fields(node);
+        return message;
+    }
+
+    static std::string trim(std::string_view s)
+    {
+        while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
+            s.remove_prefix(1);
+        while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+            s.remove_suffix(1);
+        return std::string(s);
+    }
+
+    std::map<std::string, const XmlNode*> m_type_nodes;
+    std::map<std::string, std::shared_ptr<const Type>> m_types;
+};
+
+// Code generation
+
+class Generator
+{
+public:
+    Generator(const Schema& schema, std::string source)
+        : m_schema(schema), m_source(std::move(source))
+    {
+    }
+
+    std::string generate()
+    {
+        emit_prologue();
+        for (const auto& type : m_schema.types)
+            if (type->kind == Kind::enumeration || type->kind == Kind::set)
+                emit_enum(*type);
+        m_out << "\n";
+        for (const auto& type : m_schema.types)
+            if (type->kind == Kind::primitive)
+                emit_alias(*type);
+        for (const auto& type : m_schema.types)
+            if (type->is_var_data())
+                emit_var_data(*type);
+        m_out << "\n#pragma pack(push, 1)\n";
+        for (const auto& type : m_schema.types)
+            if (type->kind == Kind::composite && !type->is_var_data())
+                emit_composite(*type);
+        for (const auto& message : m_schema.messages)
+            emit_message(message);
+        m_out << "\n#pragma pack(pop)\n";
+        m_out << m_mirrors.str();
+        emit_epilogue();
+        return m_out.str();
+    }
+
+private:
+    std::string indent(int level) const
+    {
+        return std::string(static_cast<size_t>(level) * 4, ' ');
+    }
+
+    static std::string literal(const Primitive& primitive, const std::string& value)
+    {
+        if (primitive.is_float)
+        {
+            if (value == "NaN" || value == "nan")
+                return "std::numeric_limits<" + std::string(primitive.cpp_name) + ">::quiet_NaN()";
+            auto s = value.find_first_of(".eE") == std::string::npos ? value + ".0" : value;
+            return primitive.size == 4 ? s + "f" : s;
+        }
+        if (primitive.is_char && value.size() == 1 && !std::isdigit(static_cast<unsigned char>(value[0])))
+            return "'" + value + "'";
+        if (primitive.size == 8 && primitive.is_signed && value == "-9223372036854775808")
+            return "(-9223372036854775807ll - 1)";
+        if (primitive.size == 8)
+            return value + (primitive.is_signed ? "ll" : "ull");
+        if (primitive.size == 4 && !primitive.is_signed)
+            return value + "u";
+        return value;
+    }
+
+    // host value type of a primitive (a Type/Optionull if it has attributes)
+    static std::string value_type(const Type& type, const std::string& presence)
+    {
+        const auto& primitive = *type.primitive;
+        const std::string cpp(primitive.cpp_name);
+        const bool optional = presence == "optional";
+        if (!optional && type.null_value.empty() && type.min_value.empty() && type.max_value.empty())
+            return cpp;
+        if (optional && type.min_value.empty() && type.max_value.empty())
+            return "openmsg::Optionull<" + cpp + (type.null_value.empty() ? "" : ", " + literal(primitive, type.null_value)) + ">";
+        auto bound = [&](const std::string& value, const char* name)
+        {
+            return value.empty() ? "openmsg::bounds<" + cpp + ">::" + name : literal(primitive, value);
+        };
+        return "openmsg::Type<" + cpp + ", openmsg::Attributes<" + cpp + ", openmsg::Presence::" + (optional ? "optional" : "required") + ", " +
+               bound(type.null_value, "nullValue") + ", " + bound(type.min_value, "minValue") + ", " + bound(type.max_value, "maxValue") + ">>";
+    }
+
+    // member declaration (type and array extent) of a field of a given type
+    static std::pair<std::string, std::string> declaration(const Type& type, const std::string& presence_override)
+    {
+        const auto presence = presence_override.empty() ? type.presence : presence_override;
+        switch (type.kind)
+        {
+        case Kind::primitive:
+        {
+            if (type.primitive->is_char)
+                return { type.is_named ? type.name : "openmsg::ArrayChar<" + std::to_string(type.length) + ">", "" };
+            const auto extent = type.length > 1 ? "[" + std::to_string(type.length) + "]" : "";
+            if (type.is_named && presence == type.presence)
+                return { "Wire<" + type.name + ">", extent };
+            return { "Wire<" + value_type(type, presence) + ">", extent };
+        }
+        case Kind::enumeration:
+        case Kind::set:
+            if (presence == "optional")
+            {
+                const auto null_value = type.primitive->is_char ? ", static_cast<" + type.name + ">(0)" : std::string();
+                return { "Wire<openmsg::Optionull<" + type.name + null_value + ">>", "" };
+            }
+            return { "Wire<" + type.name + ">", "" };
+        case Kind::composite:
+            return { type.name, "" };
+        default:
+            return { "", "" };
+        }
+    }
+
+    void emit_description(const std::string& description, int level)
+    {
+        if (!description.empty())
+            m_out << indent(level) << "// " << description << "\n";
+    }
+
+    void emit_prologue()
+    {
+        m_out << "// generated by sbe_codegen from " << m_source << ", do not edit\n";
+        m_out << "//\n";
+        m_out << "// schema id " << m_schema.id << ", version " << m_schema.version << ", " << m_schema.byte_order << "\n";
+        if (!m_schema.description.empty())
+            m_out << "// " << m_schema.description << "\n";
+        m_out << "\n#pragma once\n\n";
+        for (auto header : { "array_char", "attributes", "bounds", "decoded", "dispatcher", "endian_wrapper", "group", "indexed_message", "optionull", "presence", "reflection", "type", "validate", "var_data" })
+            m_out << "#include \"openmsg/" << header << ".hpp\"\n";
+        m_out << "\n#include <cstddef>\n#include <inttypes.h>\n#include <limits>\n\n";
+        m_out << "namespace " << namespace_name() << " {\n\n";
+        m_out << "constexpr static uint16_t schemaId = " << m_schema.id << ";\n";
+        m_out << "constexpr static uint16_t schemaVersion = " << m_schema.version << ";\n\n";
+        m_out << "template<openmsg::wrappable T> using Wire = openmsg::" << (m_schema.byte_order == "bigEndian" ? "BigEndian" : "LittleEndian") << "<T>;\n";
+    }
+
+    void emit_epilogue()
+    {
+        bool has_header = false;
+        for (const auto& type : m_schema.types)
+            has_header |= type->name == m_schema.header_type && type->kind == Kind::composite;
+        if (has_header && !m_schema.messages.empty())
+        {
+            m_out << "\nusing MessageDispatcher = openmsg::Dispatcher<" << m_schema.header_type;
+            for (const auto& message : m_schema.messages)
+                m_out << ", " << message.name;
+            m_out << ">;\n";
+        }
+        m_out << "\n}  // namespace " << namespace_name() << "\n";
+    }
+
+    std::string namespace_name() const
+    {
+        std::string name = m_schema.package.empty() ? "sbe" : m_schema.package;
+        std::string out;
+        for (char c : name)
+        {
+            if (c == '.')
+                out += "::";
+            else
+                out += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+        }
+        return out;
+    }
+
+    void emit_enum(const Type& type)
+    {
+        m_out << "\n";
+        emit_description(type.description, 0);
+        const auto underlying = type.primitive->is_char ? std::string("uint8_t") : std::string(type.primitive->cpp_name);
+        m_out << "enum class " << type.name << " : " << underlying << "\n{\n";
+        for (const auto& [name, value] : type.values)
+        {
+            m_out << indent(1) << name << " = ";
+            if (type.kind == Kind::set)
+                m_out << "1ull << " << value;
+            else if (type.primitive->is_char && value.size() == 1)
+                m_out << "'" << value << "'";
+            else
+                m_out << value;
+            m_out << ",\n";
+        }
+        m_out << "};\n";
+        if (type.kind == Kind::enumeration && !type.values.empty())
+        {
+            m_out << "OPENMSG_ENUM_VALUES(" << type.name;
+            for (const auto& [name, value] : type.values)
+                m_out << ", " << type.name << "::" << name;
+            m_out << ")\n";
+        }
+    }
+
+    void emit_alias(const Type& type)
+    {
+        if (type.is_constant())
+            return;  // constants are declared where they are used
+        emit_description(type.description, 0);
+        if (type.primitive->is_char)
+            m_out << "using " << type.name << " = openmsg::ArrayChar<" << type.length << ">;\n";
+        else
+            m_out << "using " << type.name << " = " << value_type(type, type.presence) << ";\n";
+    }
+
+    void emit_var_data(const Type& type)
+    {
+        const auto& length = *type.members[0].type;
+        const auto& data = *type.members[1].type;
+        m_out << "\n";
+        emit_description(type.description, 0);
+        m_out << "using " << type.name << " = openmsg::VarData<Wire<" << value_type(length, length.presence) << ">, "
+              << (data.primitive->is_char || data.primitive->size == 1 ? "char" : std::string(data.primitive->cpp_name)) << ">;\n";
+    }
+
+    // a constant (presence="constant") as a constexpr static member
+    void emit_constant(const std::string& name, const Type& type, const std::string& value_ref, int level)
+    {
+        m_out << indent(level) << "constexpr static ";
+        if (!value_ref.empty())
+        {
+            auto dot = value_ref.find('.');
+            m_out << type.name << " " << name << " = " << value_ref.substr(0, dot) << "::" << value_ref.substr(dot + 1) << ";\n";
+        }
+        else if (type.kind == Kind::primitive && type.primitive->is_char)
+            m_out << "openmsg::ArrayChar<" << type.length << "> " << name << " = \"" << type.constant << "\";\n";
+        else if (type.kind == Kind::primitive)
+            m_out << type.primitive->cpp_name << " " << name << " = " << literal(*type.primitive, type.constant) << ";\n";
+        else
+            throw std::runtime_error("unsupported constant " + name);
+    }
+
+    struct Layout
+    {
+        std::vector<std::pair<std::string, size_t>> offsets;
+        size_t size = 0;
+        int paddings = 0;
+    };
+
+    void emit_padding(Layout& layout, size_t offset, int level)
+    {
+        if (offset < layout.size)
+            throw std::runtime_error("offset " + std::to_string(offset) + " overlaps the previous field");
+        if (offset > layout.size)
+            m_out << indent(level) << "std::byte _padding" << layout.paddings++ << "[" << (offset - layout.size) << "] = {};\n";
+        layout.size = offset;
+    }
+
+    void emit_member(Layout& layout, const std::string& name, const Type& type, const std::string& presence,
+                     const std::string& value_ref, const std::string& description, long offset, int level)
+    {
+        const auto effective_presence = presence.empty() ? type.presence : presence;
+        if (effective_presence == "constant")
+        {
+            emit_description(description, level);
+            emit_constant(name, type, value_ref, level);
+            return;
+        }
+        if (offset >= 0)
+            emit_padding(layout, static_cast<size_t>(offset), level);
+        emit_description(description, level);
+        const auto [decl_type, extent] = declaration(type, presence);
+        m_out << indent(level) << decl_type << " " << name << extent << ";\n";
+        layout.offsets.emplace_back(name, layout.size);
+        layout.size += type.size();
+    }
+
+    void emit_layout_checks(const std::string& qualified_name, const Layout& layout)
+    {
+        m_out << "static_assert(sizeof(" << qualified_name << ") == " << layout.size << ");\n";
+        for (const auto& [name, offset] : layout.offsets)
+            m_out << "static_assert(offsetof(" << qualified_name << ", " << name << ") == " << qualified_name << "::" << name << "_offset);\n";
+        if (layout.offsets.empty())
+            return;
+        m_out << "OPENMSG_FIELDS(" << qualified_name;
+        for (const auto& [name, offset] : layout.offsets)
+            m_out << ", " << name;
+        m_out << ")\n";
+    }
+
+    void emit_offsets(const Layout& layout, int level)
+    {
+        for (const auto& [name, offset] : layout.offsets)
+            m_out << indent(level) << "constexpr static size_t " << name << "_offset = " << offset << ";\n";
+    }
+
+    void emit_mirror_declaration(int level)
+    {
+        m_out << "\n" << indent(level) << "struct decoded_type;  // host-native mirror (openmsg::Decoded)\n";
+    }
+
+    // host-native mirror, defined once the (packed) structures are complete
+    void emit_mirror(const std::string& qualified_name, const Layout& layout)
+    {
+        m_mirrors << "\nstruct " << qualified_name << "::decoded_type\n{\n";
+        for (const auto& [name, offset] : layout.offsets)
+            m_mirrors << indent(1) << "openmsg::host_t<decltype(" << qualified_name << "::" << name << ")> " << name << ";\n";
+        for (const auto* conversion : { "decode", "encode" })
+        {
+            const bool is_decode = std::string_view(conversion) == "decode";
+            m_mirrors << "\n" << indent(1) << "static void " << conversion << "("
+                      << (is_decode ? "const " + qualified_name + "& src, decoded_type& dst" : "const decoded_type& src, " + qualified_name + "& dst")
+                      << ") noexcept\n" << indent(1) << "{\n";
+            if (layout.offsets.empty())
+                m_mirrors << indent(2) << "(void)src;\n" << indent(2) << "(void)dst;\n";
+            for (const auto& [name, offset] : layout.offsets)
+                m_mirrors << indent(2) << "openmsg::" << conversion << "_member(src." << name << ", dst." << name << ");\n";
+            m_mirrors << indent(1) << "}\n";
+        }
+        m_mirrors << "};\n";
+    }
+
+    void emit_composite(const Type& type)
+    {
+        m_out << "\n";
+        emit_description(type.description, 0);
+        m_out << "struct " << type.name << "\n{\n";
+        Layout layout;
+        for (const auto& member : type.members)
+            emit_member(layout, member.name, *member.type, member.presence, member.value_ref, member.description, member.offset, 1);
+        if (!layout.offsets.empty())
+            m_out << "\n";
+        emit_offsets(layout, 1);
+        emit_mirror_declaration(1);
+        m_out << "};\n";
+        emit_layout_checks(type.name, layout);
+        emit_mirror(type.name, layout);
+    }
+
+    // fields of a message or group entry, returns the layout and emits nested groups
+    Layout emit_fields(const std::vector<Field>& fields, long block_length, const std::string& qualified_name, int level)
+    {
+        Layout layout;
+        for (const auto& field : fields)
+            if (field.section == Field::Section::field)
+                emit_member(layout, field.name, *field.type, field.presence, field.value_ref, field.description, field.offset, level);
+        if (block_length >= 0)
+            emit_padding(layout, static_cast<size_t>(block_length), level);
+
+        for (const auto& field : fields)
+        {
+            if (field.section == Field::Section::group)
+            {
+                m_out << "\n";
+                emit_description(field.description, level);
+                m_out << indent(level) << "struct " << field.name << "\n" << indent(level) << "{\n";
+                auto nested = qualified_name + "::" + field.name;
+                auto group_layout = emit_fields(field.fields, field.block_length, nested, level + 1);
+                m_out << indent(level) << "};\n";
+                m_out << indent(level) << "using " << field.name << "_group = openmsg::" << (field.has_variable_sections() ? "GroupCursor" : "GroupView")
+                      << "<" << field.dimension->name << ", " << field.name << ">;\n";
+                m_checks.emplace_back(nested, group_layout);
+            }
+            else if (field.section == Field::Section::data)
+            {
+                emit_description(field.description, level);
+                m_out << indent(level) << "using " << field.name << "_data = " << field.type->name << ";\n";
+            }
+        }
+
+        std::string sections;  // groups and data, in wire order (see IndexedMessage)
+        for (const auto& field : fields)
+            if (field.section != Field::Section::field)
+                sections += std::string(sections.empty() ? "" : ", ") + "openmsg::Section<\"" + field.name + "\", " + field.name +
+                            (field.section == Field::Section::group ? "_group>" : "_data>");
+        if (!sections.empty())
+            m_out << indent(level) << "using sections = openmsg::Sections<" << sections << ">;\n";
+
+        m_out << "\n" << indent(level) << "constexpr static uint16_t blockLength = " << layout.size << ";\n";
+        emit_offsets(layout, level);
+        emit_mirror_declaration(level);
+        emit_mirror(qualified_name, layout);
+        return layout;
+    }
+
+    void emit_message(const Message& message)
+    {
+        m_out << "\n";
+        emit_description(message.description, 0);
+        m_out << "struct " << message.name << "\n{\n";
+        m_out << indent(1) << "constexpr static uint16_t templateId = " << message.id << ";\n";
+        m_out << indent(1) << "constexpr static uint16_t schemaId = " << m_schema.id << ";\n";
+        m_out << indent(1) << "constexpr static uint16_t schemaVersion = " << m_schema.version << ";\n\n";
+        auto layout = emit_fields(message.fields, message.block_length, message.name, 1);
+        m_out << "};\n";
+        emit_layout_checks(message.name, layout);
+        for (const auto& [name, group_layout] : m_checks)
+            emit_layout_checks(name, group_layout);
+        m_checks.clear();
+    }
+
+    const Schema& m_schema;
+    std::string m_source;
+    std::ostringstream m_out;
+    std::ostringstream m_mirrors;
+    std::vector<std::pair<std::string, Layout>> m_checks;  // nested groups
+};
+
+}  // namespace sbe_codegen
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "usage: " << argv[0] << " schema.xml [output.hpp]\n";
+        return EXIT_FAILURE;
+    }
+    try
+    {
+        std::ifstream input(argv[1], std::ios::binary);
+        if (!input)
+            throw std::runtime_error(std::string("cannot read ") + argv[1]);
+        std::stringstream content;
+        content << input.rdbuf();
+        const auto xml = content.str();
+
+        auto root = sbe_codegen::XmlParser(xml).parse();
+        sbe_codegen::Schema schema(root);
+        std::string source = argv[1];
+        source = source.substr(source.find_last_of("/\\") + 1);
+        const auto header = sbe_codegen::Generator(schema, source).generate();
+
+        if (argc == 2)
+            std::cout << header;
+        else
+        {
+            std::ofstream output(argv[2], std::ios::binary);
+            output << header;
+            if (!output)
+                throw std::runtime_error(std::string("cannot write ") + argv[2]);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << argv[1] << ": " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -9,19 +9,47 @@
 
 #include "openmsg/bswap.hpp"
 #include "openmsg/array_char.hpp"
+#include "openmsg/ascii_number.hpp"
+#include "openmsg/bitfield.hpp"
+#include "openmsg/bulk.hpp"
+#include "openmsg/capture.hpp"
+#include "openmsg/checksum.hpp"
+#include "openmsg/columns.hpp"
 #include "openmsg/concepts.hpp"
+#include "openmsg/decimal.hpp"
+#include "openmsg/decoded.hpp"
+#include "openmsg/dispatcher.hpp"
 #include "openmsg/endian_wrapper.hpp"
+#include "openmsg/group.hpp"
+#include "openmsg/indexed_message.hpp"
+#include "openmsg/mapped_file.hpp"
 #include "openmsg/memory_wrapper.hpp"
+#include "openmsg/message_view.hpp"
+#include "openmsg/net.hpp"
 #include "openmsg/optionull.hpp"
+#include "openmsg/patch.hpp"
+#include "openmsg/pcap.hpp"
+#include "openmsg/prototype.hpp"
+#include "openmsg/reflection.hpp"
+#include "openmsg/symbol_table.hpp"
 #include "openmsg/type.hpp"
+#include "openmsg/validate.hpp"
+#include "openmsg/var_data.hpp"
+
+#include "example_schema.hpp"  // generated by sbe_codegen
 
 #include "inttypes.h"
 
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <source_location>
 #include <string.h>
@@ -39,6 +67,21 @@ void __dynamic_assert(bool value, std::source_location loc)
 #define dynamic_assert(value) __dynamic_assert((value), std::source_location::current())
 
 
+// fields shorter than a vector, from runtime strings: no vector access may go past them
+// (GCC reports those with -Warray-bounds, i.e. the build of this test is warning free)
+void test_array_short(const std::string& runtime)
+{
+    ArrayChar<4> a4(std::string_view{ runtime });
+    ArrayChar<8> a8;
+    a8 = std::string_view{ runtime };
+    ArrayChar<12> a12;
+    a12.from_array_pointer(runtime.c_str());
+    ArrayChar<20> a20(std::string_view{ runtime });
+    dynamic_assert(a4.length() == 4 && a8.length() == 6 && a12.length() == 6 && a20.length() == 6);
+    dynamic_assert(a8.to_string_view() == runtime && a12.to_string_view() == runtime && a20.to_string_view() == runtime);
+    dynamic_assert(a8.elems[7] == 0 && a12.elems[11] == 0 && a20.elems[19] == 0);
+}
+
 template<typename T>
 struct test_array
 {
@@ -105,6 +148,43 @@ static void test()
     ArrayChar_t<5> f3;
     f3.from_array_pointer(testmefurther.c_str());
     dynamic_assert(f1 == f3);
+
+    // short zero terminated string on the heap, nothing is read past its zero (see OPENMSG_SANITIZE)
+    const auto heap = std::make_unique<T[]>(4);
+    std::copy_n("abc", 4, heap.get());
+    ArrayChar_t<32> f4('x');
+    f4.from_array_pointer(heap.get());
+    dynamic_assert(f4.to_string_view() == std::basic_string_view<T>(heap.get(), 3));
+    dynamic_assert(f4.length(false) == 32 && f4.elems[3] == 0 && f4.elems[f4.size - 2] == 0);
+
+    // runtime (vectorised) paths, compared to the constexpr ones
+    const T text[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p',
+                       'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', 'A', 'B', 'C', 'D', 'E', 'F',
+                       'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V' };
+    for (size_t len = 0; len <= 40; ++len)
+    {
+        ArrayChar_t<40> g1('x');
+        g1.from_array_pointer(text, len);
+        dynamic_assert(g1.length() == len);
+        dynamic_assert(g1.to_string_view() == std::basic_string_view<T>(text, len));
+        dynamic_assert(g1.to_string_view(false).substr(len).find_first_not_of(T(0)) == std::basic_string_view<T>::npos);
+
+        T terminated[48] = {};
+        std::copy_n(text, len, terminated);
+        ArrayChar_t<40> g2('x');
+        g2.from_array_pointer(terminated);
+        dynamic_assert(g1 == g2);
+
+        ArrayChar_t<40> g3(g1);
+        dynamic_assert(g1 == g3);
+        if (len > 0)
+        {
+            g3.elems[len - 1] = 'Z';  // lower than the lowercase letters, higher than the uppercase ones
+            const auto expected = std::bit_cast<T>(static_cast<uint8_t>('Z')) <=> text[len - 1];
+            dynamic_assert((g3 <=> g1) == expected);
+            dynamic_assert((g1 <=> g3) == (0 <=> (g3 <=> g1)));
+        }
+    }
 }
 };
 
@@ -294,6 +374,78 @@ void test_type()
     }
 }
 
+template<swappable T, std::endian endian, template<swappable, std::endian> class MemoryWrapper>
+void test_bulk_endian()
+{
+    using W = EndianWrapper<T, endian, MemoryWrapper>;
+    using U = as_uint_type_t<T>;
+
+    for (size_t n : { 0, 1, 3, 7, 8, 15, 16, 17, 31, 32, 33, 64, 67 })
+    {
+        std::vector<W> wire;
+        std::vector<T> host(n);
+        for (size_t i = 0; i < n; ++i)
+            wire.emplace_back(std::bit_cast<T>(static_cast<U>(0x8091a2b3c4d5e6f7ull + i * 0x0101010101010101ull)));
+
+        dynamic_assert(mtoh(std::span<const W>(wire), std::span<T>(host)) == n);
+        for (size_t i = 0; i < n; ++i)
+            dynamic_assert(std::bit_cast<U>(host[i]) == std::bit_cast<U>(wire[i]()));
+
+        std::vector<T> inplace(n);
+        if (n > 0)
+            memcpy(inplace.data(), wire.data(), n * sizeof(W));
+        mtoh<W>(std::span<T>(inplace));
+        dynamic_assert(inplace.empty() || memcmp(inplace.data(), host.data(), n * sizeof(T)) == 0);
+
+        for (auto hint : { StoreHint::temporal, StoreHint::non_temporal, StoreHint::automatic })
+        {
+            for (size_t offset : std::initializer_list<size_t>{ 0, 1, sizeof(T) })
+            {
+                std::vector<char> buf(offset + n * sizeof(W));
+                auto encoded = std::span<W>(reinterpret_cast<W*>(buf.data() + offset), n);
+                dynamic_assert(htom(std::span<const T>(host), encoded, hint) == n);
+                dynamic_assert(n == 0 || memcmp(encoded.data(), wire.data(), n * sizeof(W)) == 0);
+            }
+        }
+
+        htom<W>(std::span<T>(inplace));
+        dynamic_assert(inplace.empty() || memcmp(inplace.data(), wire.data(), n * sizeof(W)) == 0);
+    }
+}
+
+template<swappable T>
+void test_bulk()
+{
+    test_bulk_endian<T, std::endian::little, memory_wrapper_bswap>();
+    test_bulk_endian<T, std::endian::big, memory_wrapper_bswap>();
+    test_bulk_endian<T, std::endian::big, memory_wrapper_robust>();
+    test_bulk_endian<T, std::endian::big, memory_wrapper_movbe>();
+}
+
+// every kernel supported by the CPU, not only the one selected at runtime
+template<size_t Size>
+void test_bswap_isa()
+{
+    using U = uint_of_size_t<Size>;
+    for (int isa = 0; isa <= static_cast<int>(detail_simd::detected_isa()); ++isa)
+    {
+        for (size_t n : { 0, 1, 7, 8, 16, 31, 32, 33, 64, 100 })
+        {
+            std::vector<std::byte> src(1 + n * Size), dst(1 + n * Size);
+            for (size_t i = 0; i < src.size(); ++i)
+                src[i] = static_cast<std::byte>(i * 7);
+            detail_simd::bswap_n_isa<Size>(static_cast<detail_simd::Isa>(isa), src.data() + 1, dst.data() + 1, n);  // misaligned
+            for (size_t i = 0; i < n; ++i)
+            {
+                U x, y;
+                memcpy(&x, src.data() + 1 + i * Size, Size);
+                memcpy(&y, dst.data() + 1 + i * Size, Size);
+                dynamic_assert(bswap(x) == y);
+            }
+        }
+    }
+}
+
 #pragma pack(push)
 #pragma pack(1)
 
@@ -328,6 +480,1289 @@ void test_messages()
         't', 'e', 's', 't', 'm', 'e', 0, 0, 0, 't', 'e', 's', 't', 'm', 'e', 'f', 'u', 'r' };
     static_assert(sizeof(ml) == sizeof(ml_expected));
     dynamic_assert(memcmp(&ml, ml_expected, sizeof(ml_expected)) == 0);
+
+    uint64_t c[2];
+    mtoh(mb.c, c);
+    dynamic_assert(c[0] == 0x8091a2b3c4d5e6f7ull && c[1] == 0x8091a2b3c4d5e6f7ull);
+
+    test_message<BigEndian> mc;
+    const uint16_t b[2] = { 0x8091, 0x8091 };
+    mc.c[1] = 0;
+    htom(c, mc.c);
+    htom(b, mc.b);
+    dynamic_assert(memcmp(&mc, mb_expected, sizeof(mb_expected)) == 0);
+}
+
+#pragma pack(push)
+#pragma pack(1)
+
+struct test_group_entry
+{
+    le_uint32_t id;
+    le_int16_t qty;
+};
+
+#pragma pack(pop)
+
+template<typename T>
+void append(std::vector<std::byte>& buf, const T& value, size_t size = sizeof(T))
+{
+    const auto offset = buf.size();
+    if (buf.capacity() < offset + size)  // grown ahead, GCC 12 warns (-Wstringop-overflow) on small regrowths
+        buf.reserve(std::max(2 * buf.capacity(), offset + size + 256));
+    buf.resize(offset + size, std::byte{0xCC});  // padding (e.g. newer schema version)
+    std::memcpy(buf.data() + offset, &value, sizeof(T));
+}
+
+void test_groups()
+{
+    using Header = GroupSizeEncoding<>;
+    constexpr size_t block_length = sizeof(test_group_entry) + 2;
+
+    // flat group followed by an empty group
+    std::vector<std::byte> buf;
+    append(buf, Header{ static_cast<uint16_t>(block_length), 3 });
+    for (uint32_t i = 0; i < 3; ++i)
+        append(buf, test_group_entry{ 100 + i, static_cast<int16_t>(-1 - static_cast<int>(i)) }, block_length);
+    append(buf, Header{ static_cast<uint16_t>(block_length), 0 });
+
+    GroupView<Header, test_group_entry> group(buf);
+    dynamic_assert(group.valid() && group.size() == 3 && group.block_length() == block_length);
+    dynamic_assert(group.byte_size() == sizeof(Header) + 3 * block_length);
+    dynamic_assert(group[1].id() == 101 && group.back().qty() == -3);
+    uint32_t expected_id = 100;
+    for (const auto& entry : group)
+        dynamic_assert(entry.id() == expected_id++);
+    static_assert(std::random_access_iterator<GroupView<Header, test_group_entry>::iterator>);
+    dynamic_assert(group.end() - group.begin() == 3);
+    dynamic_assert((group.begin() + 2)->id() == 102);
+
+    GroupView<Header, test_group_entry> empty(group.tail());
+    dynamic_assert(empty.valid() && empty.empty() && empty.tail().empty());
+
+    GroupView<Header, test_group_entry> truncated(std::span<const std::byte>(buf).first(buf.size() - sizeof(Header) - 1));
+    dynamic_assert(!truncated.valid() && truncated.empty());
+
+    // nested groups: 2 entries with respectively 1 and 2 nested entries, followed by 4 bytes
+    std::vector<std::byte> nested;
+    append(nested, Header{ static_cast<uint16_t>(block_length), 2 });
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        append(nested, test_group_entry{ i, 0 }, block_length);
+        append(nested, Header{ static_cast<uint16_t>(sizeof(test_group_entry)), static_cast<uint16_t>(i + 1) });
+        for (uint32_t j = 0; j <= i; ++j)
+            append(nested, test_group_entry{ 10 * i + j, 0 });
+    }
+    append(nested, le_uint32_t(0xDEADBEEFu));
+
+    GroupCursor<Header, test_group_entry> outer(nested);
+    size_t count = 0;
+    while (outer.next())
+    {
+        dynamic_assert(outer->id() == outer.index());
+        GroupView<Header, test_group_entry> inner(outer.nested());
+        dynamic_assert(inner.valid() && inner.size() == outer.index() + 1);
+        for (size_t j = 0; j < inner.size(); ++j)
+            dynamic_assert(inner[j].id() == 10 * outer.index() + j);
+        count += inner.size();
+        outer.resume(inner.tail());
+    }
+    dynamic_assert(outer.valid() && count == 3);
+    dynamic_assert(outer.tail().size() == sizeof(le_uint32_t));
+    dynamic_assert(reinterpret_cast<const le_uint32_t*>(outer.tail().data())->operator()() == 0xDEADBEEFu);
+}
+
+#pragma pack(push)
+#pragma pack(1)
+
+struct test_view_message
+{
+    be_uint32_t a;
+    le_uint16_t b[3];
+    ArrayChar<5> c;
+    test_group_entry d;
+};
+OPENMSG_FIELDS(test_view_message, a, b, c, d)
+
+#pragma pack(pop)
+
+void test_message_view()
+{
+    using View = MessageView<test_view_message>;
+    static_assert(sizeof(test_view_message) == 21);
+
+    std::vector<std::byte> buf(1);  // misaligned
+    append(buf, test_view_message{ 0xDEADBEEFu, { 1, 2, 3 }, "abc", { 42, -7 } });
+    append(buf, le_uint16_t(0xBEEF));
+    const auto bytes = std::span<const std::byte>(buf).subspan(1);
+
+    View view(bytes);
+    dynamic_assert(view.valid() && view.data() == bytes.data() && view.block_length() == sizeof(test_view_message));
+    dynamic_assert(view.value<&test_view_message::a>() == 0xDEADBEEFu);
+    dynamic_assert(view.value<&test_view_message::b>(0) == 1 && view.value<&test_view_message::b>(2) == 3);
+    dynamic_assert(view.field<&test_view_message::c>()() == "abc");
+    dynamic_assert(view.field<&test_view_message::d>().id() == 42 && view.field<&test_view_message::d>().qty() == -7);
+    dynamic_assert(view.get().b[1]() == 2);
+    dynamic_assert(view.tail().size() == 2);
+    MessageView<le_uint16_t> next(view.tail());  // chaining
+    dynamic_assert(next.valid() && next.get()() == 0xBEEF && next.tail().empty());
+
+    // larger block length (e.g. newer schema version)
+    View extended(bytes, sizeof(test_view_message) + 2);
+    dynamic_assert(extended.valid() && extended.tail().empty() && extended.bytes().size() == bytes.size());
+
+    dynamic_assert(!View(bytes.first(sizeof(test_view_message) - 1)).valid());
+    dynamic_assert(!View(bytes, bytes.size() + 1).valid());
+    dynamic_assert(!View(bytes, sizeof(test_view_message) - 1).valid());
+    dynamic_assert(!View().valid() && View().tail().empty());
+}
+
+#pragma pack(push)
+#pragma pack(1)
+
+struct test_decoded_message
+{
+    be_uint32_t a;
+    BigEndian<Optionull<int16_t>> b[5];
+    ArrayChar<3> c;
+    test_group_entry d[2];
+    struct decoded_type;
+};
+
+struct test_group_entry_mirror  // test_group_entry has no mirror, this one does
+{
+    le_uint32_t id;
+    struct decoded_type;
+};
+
+#pragma pack(pop)
+
+struct test_decoded_message::decoded_type
+{
+    host_t<decltype(test_decoded_message::a)> a;
+    host_t<decltype(test_decoded_message::b)> b;
+    host_t<decltype(test_decoded_message::c)> c;
+    host_t<decltype(test_decoded_message::d)> d;
+
+    static void decode(const test_decoded_message& src, decoded_type& dst) noexcept
+    {
+        decode_member(src.a, dst.a);
+        decode_member(src.b, dst.b);
+        decode_member(src.c, dst.c);
+        decode_member(src.d, dst.d);
+    }
+
+    static void encode(const decoded_type& src, test_decoded_message& dst) noexcept
+    {
+        encode_member(src.a, dst.a);
+        encode_member(src.b, dst.b);
+        encode_member(src.c, dst.c);
+        encode_member(src.d, dst.d);
+    }
+};
+
+struct test_group_entry_mirror::decoded_type
+{
+    host_t<decltype(test_group_entry_mirror::id)> id;
+
+    static void decode(const test_group_entry_mirror& src, decoded_type& dst) noexcept { decode_member(src.id, dst.id); }
+    static void encode(const decoded_type& src, test_group_entry_mirror& dst) noexcept { encode_member(src.id, dst.id); }
+};
+
+void test_reflection()
+{
+    using M = test_view_message;
+    static_assert(reflectable<M> && !reflectable<test_group_entry>);
+    static_assert(field_count<M> == 4);
+    static_assert(field_index<M>("c") == 2 && field_index<M>("x") == 4);
+
+    using A = field_t<M, 0>;
+    static_assert(A::name == "a" && A::offset == 0 && A::size == 4 && !A::is_array && A::extent == 1);
+    static_assert(A::is_wrapper && A::endian == std::endian::big && std::is_same_v<A::value_type, uint32_t>);
+    static_assert(std::is_same_v<A::attributes, Attributes<uint32_t>>);
+    using B = field_t<M, 1>;
+    static_assert(B::offset == 4 && B::is_array && B::extent == 3 && B::endian == std::endian::little);
+    static_assert(std::is_same_v<B::element_type, le_uint16_t>);
+    using C = field_t<M, 2>;
+    static_assert(C::offset == 10 && !C::is_wrapper && C::extent == 1 && std::is_same_v<C::value_type, char>);
+    using D = field_t<M, 3>;
+    static_assert(D::offset == 15 && !D::has_attributes && D::size == sizeof(test_group_entry));
+
+    // a generic printer
+    M msg{ 0xABCDu, { 1, 2, 3 }, "xyz", { 5, 6 } };
+    std::ostringstream out;
+    for_each_field<M>([&](auto field)
+    {
+        using F = decltype(field);
+        out << F::name << "@" << F::offset << "=";
+        if constexpr (F::is_wrapper && F::is_array)
+            for (const auto& e : F::get(msg))
+                out << e() << ";";
+        else if constexpr (F::is_wrapper)
+            out << F::get(msg)();
+        else if constexpr (std::is_same_v<typename F::member_type, ArrayChar<5>>)
+            out << F::get(msg)();
+        else
+            out << F::get(msg).id();
+        out << " ";
+    });
+    dynamic_assert(out.str() == "a@0=43981 b@4=1;2;3; c@10=xyz d@15=5 ");
+
+    for_each_field<M>([&](auto field)
+    {
+        using F = decltype(field);
+        if constexpr (F::is_wrapper)
+            std::fill_n(reinterpret_cast<typename F::element_type*>(&F::get(msg)), F::extent, typename F::element_type{});
+    });
+    dynamic_assert(msg.a() == 0 && msg.b[2]() == 0 && msg.c() == "xyz");
+}
+
+enum class test_side : uint8_t { buy = '1', sell = '2' };
+OPENMSG_ENUM_VALUES(test_side, test_side::buy, test_side::sell)
+
+#pragma pack(push)
+#pragma pack(1)
+
+struct test_validated_leg
+{
+    be_int32_t price;
+};
+OPENMSG_FIELDS(test_validated_leg, price)
+
+struct test_validated_message
+{
+    BigEndian<Type<uint32_t, Attributes<uint32_t, Presence::required, 0u, 1u, 1000u>>> quantity;
+    LittleEndian<Optionull<int16_t>> offset;
+    BigEndian<test_side> side;
+    LittleEndian<Optionull<double>> price;
+    le_uint8_t flags[2];
+    ArrayChar<4> symbol;
+    test_validated_leg leg;
+};
+OPENMSG_FIELDS(test_validated_message, quantity, offset, side, price, flags, symbol, leg)
+
+#pragma pack(pop)
+
+void test_validate()
+{
+    using M = test_validated_message;
+    static_assert(has_enum_values<test_side> && !has_enum_values<Presence>);
+    static_assert(enum_values_t<test_side>::contains(test_side::sell) && !enum_values_t<test_side>::contains(static_cast<test_side>('3')));
+
+    constexpr M valid{ 10u, {}, test_side::buy, 1.5, { 1, 2 }, "ABC", { { 7 } } };
+    static_assert(validate(valid) == 0 && is_valid(valid));  // optional null offset is valid
+
+    auto msg = valid;
+    msg.quantity = 0u;                             // below minValue
+    msg.side = static_cast<test_side>('1' + 5);    // in range, not an enumerator
+    msg.price = std::numeric_limits<double>::quiet_NaN();  // nullValue
+    msg.flags[1] = 0xFF;                           // nullValue of a required field
+    msg.symbol = "\x01";                           // not checked
+    msg.leg.price = std::numeric_limits<int32_t>::min();
+    dynamic_assert(validate(msg) == 0b1010101u);
+    msg.offset = std::numeric_limits<int16_t>::min() + 1;
+    msg.price = 2.0;
+    dynamic_assert(validate(msg) == 0b1010101u && !is_valid(msg));
+
+    std::vector<M> batch(37, valid);
+    batch[3].quantity = 1001u;
+    batch[20] = msg;
+    batch[36].side = static_cast<test_side>(0);
+    std::vector<violations_t> violations(batch.size() + 1, ~violations_t{ 0 });
+    dynamic_assert(validate(std::span<const M>(batch), std::span(violations)) == 3);
+    dynamic_assert(violations[3] == 0b1u && violations[20] == 0b1010101u && violations[36] == 0b100u);
+    dynamic_assert(violations[0] == 0 && violations[35] == 0 && violations[37] == ~violations_t{ 0 });
+}
+
+void test_columns()
+{
+    using M = test_validated_message;
+    std::vector<M> msgs(1000);  // more than one block
+    for (size_t i = 0; i < msgs.size(); ++i)
+    {
+        auto& msg = msgs[i];
+        msg.quantity = static_cast<uint32_t>(i);
+        if (i % 3 == 0)
+            msg.offset = static_cast<int16_t>(-static_cast<int>(i));
+        msg.side = i % 2 ? test_side::sell : test_side::buy;
+        if (i % 5 != 0)
+            msg.price = 0.5 * static_cast<double>(i);
+        msg.flags[0] = static_cast<uint8_t>(i);
+        msg.flags[1] = static_cast<uint8_t>(i >> 8);
+        if (i % 2)
+            msg.symbol = "ODD";
+        msg.leg.price = static_cast<int32_t>(i * 7);
+    }
+
+    const auto columns = transpose(std::span<const M>(msgs));
+    static_assert(std::is_same_v<decltype(columns.column<"price">().values())::element_type, const double>);
+    static_assert(Column<field_t<M, 1>>::is_optional && !Column<field_t<M, 0>>::is_optional);
+    dynamic_assert(columns.size() == 1000 && columns.column<"flags">().size() == 2000);
+    dynamic_assert(columns.column<0>().nulls().empty() && columns.column<"offset">().nulls().size() == 16);
+    bool same = true;
+    for (size_t i = 0; i < msgs.size(); ++i)
+    {
+        same &= columns.column<"quantity">().values()[i] == i;
+        same &= columns.column<"offset">().is_null(i) == (i % 3 != 0);
+        same &= i % 3 != 0 || columns.column<"offset">().values()[i] == -static_cast<int>(i);
+        same &= columns.column<"side">().values()[i] == msgs[i].side();
+        same &= columns.column<"price">().is_null(i) == (i % 5 == 0);
+        same &= i % 5 == 0 || columns.column<"price">().values()[i] == 0.5 * static_cast<double>(i);
+        same &= columns.column<"flags">().values(i)[0] == static_cast<uint8_t>(i) && columns.column<"flags">().values(i)[1] == static_cast<uint8_t>(i >> 8);
+        same &= columns.column<"symbol">().values()[i] == msgs[i].symbol;
+        same &= columns.column<"leg">().column<"price">().values()[i] == static_cast<int32_t>(i * 7);  // host value
+    }
+    dynamic_assert(same);
+
+    Columns<M> empty;
+    transpose(std::span<const M>(), empty);
+    dynamic_assert(empty.empty() && empty.column<"price">().size() == 0);
+}
+
+void test_interleave()
+{
+    using M = test_validated_message;
+    std::vector<M> msgs(1500);
+    for (size_t i = 0; i < msgs.size(); ++i)
+    {
+        msgs[i].quantity = static_cast<uint32_t>(i * 3);
+        if (i % 4 == 0)
+            msgs[i].price = static_cast<double>(i);
+        msgs[i].flags[1] = static_cast<uint8_t>(i);
+        msgs[i].leg.price = -static_cast<int32_t>(i);
+    }
+
+    // round trip, with some entries made missing through the null bitmap
+    auto columns = transpose(std::span<const M>(msgs));
+    columns.column<"price">().set_null(4, true);
+    msgs[4].price = LittleEndian<Optionull<double>>();
+    std::vector<M> out(msgs.size() + 1);
+    std::memset(reinterpret_cast<std::byte*>(out.data()), 0xAA, out.size() * sizeof(M));
+    dynamic_assert(interleave(columns, std::span<M>(out)) == msgs.size());
+    dynamic_assert(std::memcmp(out.data(), msgs.data(), msgs.size() * sizeof(M)) == 0);
+    dynamic_assert(out.back().quantity.storage_value() == 0xAAAAAAAAu);  // not written
+
+    // one span per field
+    std::vector<uint32_t> quantity{ 1, 2, 3 };
+    std::vector<int16_t> offset{ 5, std::numeric_limits<int16_t>::min(), 7 };
+    std::vector<test_side> side{ test_side::buy, test_side::sell, test_side::buy };
+    std::vector<double> price{ 1.25, 2.5, 3.75 };
+    std::vector<uint8_t> flags{ 1, 2, 3, 4, 5, 6 };
+    std::vector<ArrayChar<4>> symbol{ "A", "BB", "CCC" };
+    std::vector<test_validated_leg> leg{ { { 10 } }, { { 20 } } };  // shortest span
+    std::vector<M> built(3);
+    dynamic_assert(interleave(std::span<M>(built), std::span<const uint32_t>(quantity), std::span<const int16_t>(offset), std::span<const test_side>(side),
+                              std::span<const double>(price), std::span<const uint8_t>(flags), std::span<const ArrayChar<4>>(symbol),
+                              std::span<const test_validated_leg>(leg)) == 2);
+    dynamic_assert(built[1].quantity() == 2 && built[0].offset() == 5 && built[1].offset() == std::numeric_limits<int16_t>::min());
+    dynamic_assert(built[1].side() == test_side::sell && built[1].price() == 2.5 && built[1].flags[0]() == 3 && built[1].flags[1]() == 4);
+    dynamic_assert(built[1].symbol() == "BB" && built[1].leg.price() == 20 && built[2].quantity() == 0);
+    dynamic_assert(std::memcmp(&built[0].quantity, "\x00\x00\x00\x01", 4) == 0);  // big endian
+
+    // composite of a generated message (Decimal with an optional mantissa), member by member
+    namespace ex = example::orders;
+    std::vector<ex::NewOrder> orders(3);
+    orders[0].price.mantissa = 1012500;
+    orders[2].price.mantissa = -5;
+    const auto order_columns = transpose(std::span<const ex::NewOrder>(orders));
+    const auto& mantissas = order_columns.column<"price">().column<"mantissa">();
+    dynamic_assert(mantissas.values()[0] == 1012500 && mantissas.is_null(1) && !mantissas.is_null(2) && mantissas.values()[2] == -5);
+    std::vector<ex::NewOrder> rebuilt(orders.size());
+    dynamic_assert(interleave(order_columns, std::span(rebuilt)) == orders.size());  // nulls written back as nullValue
+    dynamic_assert(std::memcmp(rebuilt.data(), orders.data(), orders.size() * sizeof(ex::NewOrder)) == 0);
+}
+
+void test_capture()
+{
+    // [BigEndian<uint16_t> length][payload] records, the last one truncated
+    using M = test_view_message;
+    std::vector<std::byte> buf;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        append(buf, be_uint16_t(static_cast<uint16_t>(sizeof(M) + i)));
+        append(buf, M{ i, { 1, 2, 3 }, "abc", { i * 2, 0 } }, sizeof(M) + i);
+    }
+    append(buf, be_uint16_t(0));  // empty payload
+    const auto complete = buf.size();
+    append(buf, be_uint16_t(100));
+    append(buf, le_uint32_t(0));
+
+    CaptureReader<be_uint16_t> reader(buf, 64);
+    CaptureRecord records[4];
+    size_t n = 0, total = 0, batches = 0;
+    bool same = true;
+    while ((n = reader.next(records)) != 0)
+    {
+        for (size_t j = 0; j < n; ++j, ++total)
+        {
+            if (total == 10)
+            {
+                same &= records[j].payload.empty() && !records[j].view<M>();
+                continue;
+            }
+            const auto view = records[j].view<M>();
+            const auto msg = view.valid() ? view.get() : M{};
+            same &= view && msg.a() == total && msg.d.id() == total * 2 && view.tail().size() == total;
+        }
+        ++batches;
+    }
+    dynamic_assert(same && total == 11 && batches == 3 && reader.count() == 11);
+    dynamic_assert(!reader.valid() && !reader.at_end() && reader.tail().size() == buf.size() - complete);
+
+    CaptureReader<be_uint16_t> complete_reader{ std::span<const std::byte>(buf).first(complete) };
+    CaptureRecord record;
+    while (complete_reader.next(record))
+        ;
+    dynamic_assert(complete_reader.valid() && complete_reader.at_end() && complete_reader.count() == 11);
+
+    // from a memory mapped file
+    const auto path = (std::filesystem::temp_directory_path() / "openmsg_test_capture.bin").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(complete));
+    }
+    MappedFile file(path.c_str(), { .populate = true, .sequential = true, .huge_pages = true });
+    dynamic_assert(file && file.size() == complete && std::memcmp(file.data().data(), buf.data(), complete) == 0);
+    CaptureReader<be_uint16_t> file_reader(file.data());
+    dynamic_assert(file_reader.next(records) == 4 && reinterpret_cast<const M*>(records[3].payload.data())->a() == 3);
+    MappedFile moved(std::move(file));
+    dynamic_assert(!file && moved && moved.size() == complete);
+    moved.close();
+    std::remove(path.c_str());
+    dynamic_assert(!moved && !MappedFile(path.c_str()));
+}
+
+// Ethernet, optional VLAN, IPv4/UDP or IPv6/TCP frame around a payload
+std::vector<std::byte> make_frame(bool ipv6, bool vlan, std::string_view payload)
+{
+    using namespace net;
+    std::vector<std::byte> frame;
+    append(frame, EthernetHeader{ { { 1, 2, 3, 4, 5, 6 } }, { { 7, 8, 9, 10, 11, 12 } }, vlan ? EtherType::vlan : (ipv6 ? EtherType::ipv6 : EtherType::ipv4) });
+    if (vlan)
+        append(frame, VlanTag{ static_cast<uint16_t>(0x6000 | 42), ipv6 ? EtherType::ipv6 : EtherType::ipv4 });
+    if (ipv6)
+    {
+        append(frame, Ipv6Header{ 0x60000000u, static_cast<uint16_t>(8 + sizeof(TcpHeader) + 4 + payload.size()), IpProtocol::destination_options, 64, {}, {} });
+        append(frame, Ipv6ExtensionHeader{ IpProtocol::tcp, 0 }, 8);
+        append(frame, TcpHeader{ 1234, 80, 1, 2, static_cast<uint16_t>((6 << 12) | TcpHeader::ack | TcpHeader::psh), 1024, 0, 0 }, sizeof(TcpHeader) + 4);
+    }
+    else
+    {
+        append(frame, Ipv4Header{ 0x45, 0, static_cast<uint16_t>(sizeof(Ipv4Header) + sizeof(UdpHeader) + payload.size()), 1, 0, 64, IpProtocol::udp, 0, 0x0A000001u, 0x0A000002u });
+        append(frame, UdpHeader{ 5000, 6000, static_cast<uint16_t>(sizeof(UdpHeader) + payload.size()), 0 });
+    }
+    auto p = reinterpret_cast<const std::byte*>(payload.data());
+    frame.insert(frame.end(), p, p + payload.size());
+    frame.resize(std::max<size_t>(frame.size(), 60), std::byte{ 0 });  // Ethernet padding
+    return frame;
+}
+
+void test_net()
+{
+    using namespace net;
+    static_assert(field_count<Ipv4Header> == 10 && field_t<TcpHeader, 4>::offset == 12);
+
+    auto frame = make_frame(false, true, "hello");
+    auto layers = decode_layers(frame);
+    dynamic_assert(!layers.truncated && layers.ethernet->source.bytes[5] == 12 && layers.vlan_count == 1 && layers.vlan->vlanId() == 42 && layers.vlan->priority() == 3);
+    dynamic_assert(layers.ipv4 && layers.ipv4->version() == 4 && layers.ipv4->headerLength() == 20 && layers.ipv4->destination() == 0x0A000002u);
+    dynamic_assert(layers.is_udp() && layers.udp->destinationPort() == 6000 && std::string_view(reinterpret_cast<const char*>(layers.payload.data()), layers.payload.size()) == "hello");
+
+    frame = make_frame(true, false, "0123456789abcdef0123456789");
+    layers = decode_layers(frame);
+    dynamic_assert(!layers.truncated && layers.ipv6 && layers.ipv6->version() == 6 && layers.protocol == IpProtocol::tcp && !layers.vlan);
+    dynamic_assert(layers.is_tcp() && layers.tcp->headerLength() == 24 && layers.tcp->flags() == (TcpHeader::ack | TcpHeader::psh) && layers.payload.size() == 26);
+
+    // raw IP link, truncated frames
+    frame = make_frame(false, false, "abc");
+    dynamic_assert(decode_layers(std::span(frame).subspan(sizeof(EthernetHeader)), LinkType::raw).payload.size() == 3);
+    dynamic_assert(decode_layers(std::span(frame).first(30)).truncated && decode_layers(std::span(frame).first(10)).truncated);
+    layers = decode_layers(std::span(frame).first(40));  // IPv4 header but no full UDP header
+    dynamic_assert(layers.truncated && layers.ipv4 && !layers.udp);
+}
+
+template<template<typename...> class W>
+void append_pcap_record(std::vector<std::byte>& buf, uint32_t seconds, uint32_t fraction, const std::vector<std::byte>& frame)
+{
+    append(buf, net::PcapRecordHeader<W>{ seconds, fraction, static_cast<uint32_t>(frame.size()), static_cast<uint32_t>(frame.size()) });
+    buf.insert(buf.end(), frame.begin(), frame.end());
+}
+
+void test_pcap()
+{
+    using namespace net;
+    const auto udp = make_frame(false, false, "udp payload");
+    const auto tcp = make_frame(true, true, "tcp payload");
+
+    // pcap, big endian with nanoseconds, then little endian with microseconds
+    std::vector<std::byte> be;
+    append(be, PcapFileHeader<BigEndian>{ 0xA1B23C4Du, 2, 4, 0, 0, 65535, 1 });
+    append_pcap_record<BigEndian>(be, 10, 5, udp);
+    append_pcap_record<BigEndian>(be, 11, 6, tcp);
+    PcapReader be_reader(be, 0);
+    Packet packets[4];
+    dynamic_assert(be_reader.format() == CaptureFormat::pcap && be_reader.next(packets) == 2 && be_reader.valid() && be_reader.at_end());
+    dynamic_assert(packets[0].timestamp_ns == 10000000005u && packets[1].timestamp_ns == 11000000006u && packets[1].frame.size() == tcp.size());
+    dynamic_assert(packets[0].layers().is_udp() && packets[1].layers().is_tcp() && packets[1].layers().payload.size() == 11);
+
+    std::vector<std::byte> le;
+    append(le, PcapFileHeader<LittleEndian>{ 0xA1B2C3D4u, 2, 4, 0, 0, 65535, 1 });
+    append_pcap_record<LittleEndian>(le, 1, 2, udp);
+    append_pcap_record<LittleEndian>(le, 1, 3, udp);
+    le.resize(le.size() - 1);  // truncated
+    PcapReader le_reader(le);
+    Packet packet;
+    dynamic_assert(le_reader.next(packet) && packet.timestamp_ns == 1000002000u && packet.original_length == udp.size());
+    dynamic_assert(!le_reader.next(packet) && !le_reader.valid() && le_reader.count() == 1);
+
+    // pcapng: section, interface (nanoseconds), unknown block, enhanced and simple packets
+    std::vector<std::byte> ng;
+    append(ng, PcapngSectionHeader<LittleEndian>{ { 0x0A0D0D0Au, 28 }, 0x1A2B3C4Du, 1, 0, -1 });
+    append(ng, le_uint32_t(28));
+    append(ng, PcapngInterfaceDescription<LittleEndian>{ { 1u, 28 }, 1, 0, 65535 });
+    append(ng, PcapngOption<LittleEndian>{ 9, 1 });
+    append(ng, le_uint32_t(9));  // if_tsresol = 9, padded
+    append(ng, le_uint32_t(28));
+    append(ng, PcapngBlockHeader<LittleEndian>{ 0x0BADu, 16 });
+    append(ng, le_uint32_t(0));
+    append(ng, le_uint32_t(16));
+    const auto padded = (tcp.size() + 3) & ~size_t{ 3 };
+    const auto epb_length = static_cast<uint32_t>(sizeof(PcapngEnhancedPacket<LittleEndian>) + padded + 4);
+    append(ng, PcapngEnhancedPacket<LittleEndian>{ { 6u, epb_length }, 0, 1, 2, static_cast<uint32_t>(tcp.size()), static_cast<uint32_t>(tcp.size() + 100) });
+    ng.insert(ng.end(), tcp.begin(), tcp.end());
+    ng.resize(ng.size() + padded - tcp.size(), std::byte{ 0 });
+    append(ng, le_uint32_t(epb_length));
+    const auto spb_length = static_cast<uint32_t>(sizeof(PcapngSimplePacket<LittleEndian>) + udp.size() + 4);
+    append(ng, PcapngSimplePacket<LittleEndian>{ { 3u, spb_length }, static_cast<uint32_t>(udp.size()) });
+    ng.insert(ng.end(), udp.begin(), udp.end());
+    append(ng, le_uint32_t(spb_length));
+    PcapReader ng_reader(ng);
+    dynamic_assert(ng_reader.format() == CaptureFormat::pcapng && ng_reader.next(packets) == 2 && ng_reader.valid() && ng_reader.at_end());
+    dynamic_assert(packets[0].timestamp_ns == (uint64_t{ 1 } << 32) + 2 && packets[0].original_length == tcp.size() + 100 && packets[0].layers().is_tcp());
+    dynamic_assert(packets[1].frame.size() == udp.size() && packets[1].layers().is_udp() && packets[0].interface_index == 0);
+
+    // unsupported major versions: pcap 3, pcapng 2
+    std::vector<std::byte> v3;
+    append(v3, PcapFileHeader<LittleEndian>{ 0xA1B2C3D4u, 3, 0, 0, 0, 65535, 1 });
+    append_pcap_record<LittleEndian>(v3, 1, 2, udp);
+    PcapReader v3_reader(v3);
+    dynamic_assert(v3_reader.format() == CaptureFormat::pcap && !v3_reader.valid() && !v3_reader.next(packet));
+    auto ng2 = ng;
+    ng2[12] = std::byte{ 2 };  // versionMajor, after the block header and the byte order magic
+    PcapReader ng2_reader(ng2);
+    dynamic_assert(ng2_reader.next(packets) == 0 && !ng2_reader.valid());
+
+    static_assert(detail_pcap::to_nanoseconds(3, 6) == 3000 && detail_pcap::to_nanoseconds(30, 10) == 3);
+    static_assert(detail_pcap::to_nanoseconds((5ull << 20) + (1ull << 19), 0x80 | 20) == 5500000000u);
+    dynamic_assert(!PcapReader(udp).valid());
+}
+
+enum class test_order_type : uint8_t { market = 1, limit = 2, stop = 3 };
+
+using test_order_word = BitPack<be_uint16_t,
+                                BitField<"type", 0, 2, test_order_type, Attributes<test_order_type, Presence::required, test_order_type{ 0 }, test_order_type::market, test_order_type::stop>>,
+                                BitField<"adjust", 2, 5, int8_t>,
+                                BitField<"flags", 8, 4>>;
+
+#pragma pack(push, 1)
+struct test_bitfield_message
+{
+    be_uint32_t id;
+    test_order_word word;
+};
+OPENMSG_FIELDS(test_bitfield_message, id, word)
+#pragma pack(pop)
+
+void test_bitfield()
+{
+    using Word = test_order_word;
+    using Type = Word::field_t<0>;
+    using Adjust = Word::field_t<1>;
+    using Flags = Word::field_t<2>;
+    static_assert(sizeof(Word) == 2 && Word::field_count == 3 && std::is_trivially_copyable_v<Word>);
+    static_assert(Flags::mask<uint16_t> == 0x0F00 && Adjust::minValue == -16 && Adjust::maxValue == 15 && Flags::maxValue == 15);
+    static_assert(std::is_same_v<Flags::value_type, uint8_t> && std::is_same_v<BitField<"wide", 0, 12>::value_type, uint16_t>);
+
+    constexpr auto word = Word::make(test_order_type::limit, -3, 0xA);
+    static_assert(word() == ((0xA << 8) | ((-3 & 0x1F) << 2) | 2));
+    static_assert(word.get<"type">() == test_order_type::limit && word.get<Adjust>() == -3 && word.get<2>() == 0xA);
+    dynamic_assert(reinterpret_cast<const uint8_t*>(&word)[0] == 0x0A && reinterpret_cast<const uint8_t*>(&word)[1] == ((((-3 & 0x1F) << 2) | 2) & 0xFF));
+
+    // a field is updated without touching the others, values are truncated to their width
+    auto copy = word;
+    copy.set<"adjust">(15);
+    dynamic_assert(copy.get<"type">() == test_order_type::limit && copy.get<"adjust">() == 15 && copy.get<"flags">() == 0xA);
+    copy.set<Flags>(0x1F);
+    dynamic_assert(copy.get<Flags>() == 0xF && copy.get<Adjust>() == 15 && copy() >> 12 == 0);
+    const auto [type, adjust, flags] = copy.unpack();
+    dynamic_assert(type == test_order_type::limit && adjust == 15 && flags == 0xF);
+
+    // bounds from the attributes
+    dynamic_assert(copy.in_bound());
+    copy.set<"type">(test_order_type{ 0 });
+    dynamic_assert(!copy.in_bound() && !Type::in_bound(test_order_type{ 0 }) && Adjust::in_bound(-16) && !Adjust::in_bound(16));
+    dynamic_assert(validate(test_bitfield_message{ 1, word }) == 0 && validate(test_bitfield_message{ 1, copy }) == 0b10);
+
+    // little endian storage, fields spanning bytes
+    using LeWord = BitPack<le_uint32_t, BitField<"low", 0, 12>, BitField<"high", 12, 20>>;
+    const auto le = LeWord::make(0xABC, 0x12345);
+    dynamic_assert(le() == 0x12345ABC && reinterpret_cast<const uint8_t*>(&le)[0] == 0xBC && le.get<"high">() == 0x12345);
+
+    // network headers
+    net::Ipv4Header ip{};
+    ip.versionIhl = decltype(ip.versionIhl)::make(4, 5);
+    ip.flagsFragmentOffset.set<"fragmentOffset">(100);
+    ip.flagsFragmentOffset.set<"flags">(1);
+    dynamic_assert(ip.version() == 4 && ip.headerLength() == 20 && ip.fragmentOffset() == 800 && ip.moreFragments());
+    dynamic_assert(reinterpret_cast<const uint8_t*>(&ip)[0] == 0x45 && reinterpret_cast<const uint8_t*>(&ip)[6] == 0x20);
+    dynamic_assert(is_valid(ip));
+}
+
+// RFC 1071 reference, one big endian word at a time
+uint16_t reference_checksum(std::span<const std::byte> data)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < data.size(); i += 2)
+    {
+        sum += std::to_integer<uint32_t>(data[i]) << 8;
+        if (i + 1 < data.size())
+            sum += std::to_integer<uint32_t>(data[i + 1]);
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(~sum);
+}
+
+void test_checksum()
+{
+    // RFC 1071 kernels, for all the sizes and alignments up to a few vectors, and large buffers
+    std::vector<std::byte> data(3 * 1024 * 1024);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<std::byte>((i * 0x9E3779B1u) >> 13);
+    for (size_t offset = 0; offset < 4; ++offset)
+        for (size_t n = 0; n < 300; ++n)
+            dynamic_assert(internet_checksum(std::span(data).subspan(offset, n)) == reference_checksum(std::span(data).subspan(offset, n)));
+    dynamic_assert(internet_checksum(std::span(data).subspan(1)) == reference_checksum(std::span(data).subspan(1)));
+    std::fill(data.begin(), data.end(), std::byte{ 0xFF });
+    dynamic_assert(internet_checksum(data) == reference_checksum(data) && ones_complement_sum(data) == 0xFFFF);
+
+    // sums of spans, the first ones having an even size
+    const auto all = std::span(data).first(1001);
+    dynamic_assert(internet_checksum(all.subspan(64), ones_complement_sum(all.first(64))) == internet_checksum(all));
+    static_assert(ones_complement_add(0xFFFF, 1) == 1 && ones_complement_add(0x8000, 0x8000) == 1);
+
+    // IPv4 header checksum
+    const uint8_t header_bytes[] = { 0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11, 0xB8, 0x61, 0xC0, 0xA8, 0x00, 0x01, 0xC0, 0xA8, 0x00, 0xC7 };
+    net::Ipv4Header ip;
+    std::memcpy(&ip, header_bytes, sizeof(ip));
+    dynamic_assert(net::ipv4_checksum(ip) == 0xB861 && verify_checksum(std::as_bytes(std::span(header_bytes))));
+
+    // incremental updates (RFC 1624) of 8-bit fields at even and odd positions, BitPack and 32-bit fields
+    set_checksummed(ip.ttl, 3, ip.checksum);
+    dynamic_assert(ip.checksum() == net::ipv4_checksum(ip));
+    set_checksummed(ip.protocol, net::IpProtocol::tcp, ip.checksum);
+    dynamic_assert(ip.checksum() == net::ipv4_checksum(ip));
+    set_checksummed(ip.flagsFragmentOffset, 0x2001, ip.checksum);
+    set_checksummed(ip.destination, 0x0A0B0C0Du, ip.checksum);
+    dynamic_assert(ip.checksum() == net::ipv4_checksum(ip) && ip.fragmentOffset() == 8 && ip.moreFragments());
+    static_assert(update_checksum(0xDD2F, 0x5555, 0x3285) == 0x0000);  // RFC 1624 example
+
+    // UDP and TCP checksums with their pseudo-headers, updated when rewriting ports and sequence numbers
+    for (bool ipv6 : { false, true })
+    {
+        auto frame = make_frame(ipv6, !ipv6, "an odd sized payload");
+        auto layers = net::decode_layers(frame);
+        auto segment = net::transport_segment(layers);
+        dynamic_assert(!segment.empty() && segment.data() + segment.size() == layers.payload.data() + layers.payload.size());
+        const auto checksum = net::transport_checksum(layers);
+        dynamic_assert(checksum != 0);
+        if (ipv6)
+        {
+            dynamic_assert(layers.tcp != nullptr);
+            auto& tcp = *const_cast<net::TcpHeader*>(layers.tcp);
+            tcp.checksum = checksum;
+            dynamic_assert(verify_checksum(segment, net::pseudo_header_sum(layers, segment.size())));
+            set_checksummed(tcp.sequenceNumber, 0x12345678u, tcp.checksum);
+            set_checksummed(tcp.destinationPort, 8080, tcp.checksum);
+            dynamic_assert(tcp.checksum() == net::transport_checksum(layers));
+        }
+        else
+        {
+            dynamic_assert(layers.udp != nullptr);
+            auto& udp = *const_cast<net::UdpHeader*>(layers.udp);
+            udp.checksum = checksum;
+            dynamic_assert(verify_checksum(segment, net::pseudo_header_sum(layers, segment.size())));
+            set_udp_checksummed(udp.destinationPort, 9999, udp.checksum);
+            dynamic_assert(udp.checksum() == net::transport_checksum(layers));
+            // a pseudo-header field, covered by both checksums
+            auto& ipv4 = *const_cast<net::Ipv4Header*>(layers.ipv4);
+            ipv4.checksum = net::ipv4_checksum(ipv4);
+            const auto old_source = ipv4.source;
+            set_udp_checksummed(ipv4.source, 0xC0A80101u, udp.checksum);
+            ipv4.checksum = update_checksum(ipv4.checksum(), std::as_bytes(std::span(&old_source, 1)), std::as_bytes(std::span(&ipv4.source, 1)));
+            dynamic_assert(udp.checksum() == net::transport_checksum(layers) && ipv4.checksum() == net::ipv4_checksum(ipv4));
+            // no UDP checksum (0) is left as is
+            udp.checksum = 0;
+            set_udp_checksummed(udp.destinationPort, 7777, udp.checksum);
+            dynamic_assert(udp.checksum() == 0 && udp.destinationPort() == 7777);
+            // an update summing to 0 is sent as 0xFFFF: the port takes what brings the sum to 0xFFFF
+            udp.checksum = net::transport_checksum(layers);
+            const auto port = udp.destinationPort();
+            const auto zeroing_port = static_cast<uint16_t>(~ones_complement_add(static_cast<uint16_t>(~udp.checksum()), static_cast<uint16_t>(~port)));
+            set_udp_checksummed(udp.destinationPort, zeroing_port, udp.checksum);
+            dynamic_assert(udp.destinationPort() == zeroing_port && udp.checksum() == 0xFFFF && net::transport_checksum(layers) == 0xFFFF);
+        }
+    }
+}
+
+#pragma pack(push, 1)
+struct test_patch_message
+{
+    be_uint32_t seqNum;
+    be_uint64_t sendingTime;
+    be_uint16_t sessionId;
+};
+OPENMSG_FIELDS(test_patch_message, sessionId, sendingTime, seqNum)  // not in offset order
+#pragma pack(pop)
+
+void test_patch()
+{
+    std::vector<std::byte> buffer(sizeof(test_validated_message) + 1);
+    dynamic_assert(!Patch<test_validated_message>(std::span(buffer).first(sizeof(test_validated_message) - 1)));
+
+    Patch<test_validated_message> patch(buffer);
+    static_assert(Patch<test_validated_message>::mask_words == 1);
+    dynamic_assert(patch && patch.block_length() == sizeof(test_validated_message) && !patch.any_dirty());
+    ByteRange ranges[4];
+    dynamic_assert(patch.dirty_ranges(ranges) == 0);
+
+    patch.set<"offset">(-5);
+    patch.set<"quantity">(10);
+    dynamic_assert(patch.is_dirty<"quantity">() && patch.is_dirty(1) && !patch.is_dirty<"side">() && patch.dirty_count() == 2);
+    dynamic_assert(patch.value<"quantity">() == 10 && patch.value<"offset">() == -5 && patch.get().quantity() == 10);
+    dynamic_assert(patch.dirty_ranges(ranges) == 1 && ranges[0] == (ByteRange{ 0, 6 }));
+
+    // adjacent fields are merged, other members mark their field, array elements their own bytes
+    patch.set<"symbol">("XY");
+    dynamic_assert(patch.set<"flags">(1, 7) && !patch.set<"flags">(2, 9));
+    patch.set<"leg">(test_validated_leg{ 42 });
+    dynamic_assert(patch.value<"symbol">()() == "XY" && patch.value<"flags">(1) == 7 && patch.value<"flags">(0) == 0 && patch.value<"leg">().price() == 42);
+    dynamic_assert(patch.dirty_ranges(ranges) == 2 && ranges[1] == (ByteRange{ 16, 9 }) && patch.dirty() == (Patch<test_validated_message>::mask_type{ 0b1110011 }));
+    size_t bytes = 0;
+    patch.for_each_dirty_range([&](ByteRange range) { bytes += patch.bytes(range).size(); });
+    dynamic_assert(bytes == 15 && patch.dirty_ranges(std::span(ranges, 1)) == 2);
+    patch.set<"flags">(0, 1);
+    dynamic_assert(patch.dirty_ranges(ranges) == 2 && ranges[1] == (ByteRange{ 15, 10 }));
+
+    // the bytes out of the written fields are left as they are
+    patch.clear();
+    dynamic_assert(!patch.any_dirty() && patch.get().side() == test_side{ 0 } && buffer.back() == std::byte{ 0 });
+
+    // ranges are in offset order, whatever the registration order
+    std::byte raw[sizeof(test_patch_message)] = {};
+    Patch<test_patch_message> forward(raw);
+    forward.set<"sessionId">(3);
+    forward.set<"seqNum">(1000);
+    dynamic_assert(forward.dirty_ranges(ranges) == 2 && ranges[0] == (ByteRange{ 0, 4 }) && ranges[1] == (ByteRange{ 12, 2 }));
+    forward.set<"sendingTime">(123456789);
+    dynamic_assert(forward.dirty_ranges(ranges) == 1 && ranges[0] == (ByteRange{ 0, 14 }) && Patch<test_patch_message>::field_range(1) == (ByteRange{ 4, 8 }));
+    dynamic_assert(std::to_integer<int>(raw[3]) == 0xE8 && std::to_integer<int>(raw[13]) == 3);
+}
+
+#pragma pack(push, 1)
+struct test_order_frame
+{
+    example::orders::messageHeader header;
+    example::orders::NewOrder order;
+};
+#pragma pack(pop)
+
+void test_prototype()
+{
+    namespace ex = example::orders;
+    static_assert(alignof(Prototype<ex::NewOrder>) == prototype_alignment && prototype<ex::NewOrder>.image().size() == ex::NewOrder::blockLength);
+
+    // image of the default message, rendered at compile time
+    constexpr auto& image = prototype<ex::NewOrder>.image();
+    static_assert(image[ex::NewOrder::timeInForce_offset] == std::byte{ 0xFF } && image[ex::NewOrder::orderId_offset] == std::byte{ 0 });
+    const ex::NewOrder constructed{};
+    const auto order = prototype<ex::NewOrder>.get();
+    dynamic_assert(std::memcmp(prototype<ex::NewOrder>.bytes().data(), &constructed, sizeof(constructed)) == 0);
+    dynamic_assert(order.price.mantissa() == bounds<int64_t>::nullValue && order.timeInForce() == bounds<ex::TimeInForce>::nullValue && order.orderId() == 0);
+
+    // image with the constant fields set, then the fields of an order
+    constexpr Prototype<test_order_frame> new_order([]
+    {
+        test_order_frame frame{};
+        frame.header = ex::messageHeader{ ex::NewOrder::blockLength, ex::NewOrder::templateId, ex::schemaId, ex::schemaVersion };
+        frame.order.execInst = ex::ExecInst::Hidden;
+        return frame;
+    }());
+
+    std::vector<std::byte> buffer(sizeof(test_order_frame), std::byte{ 0xCC });
+    dynamic_assert(!new_order.render(std::span(buffer).first(sizeof(test_order_frame) - 1)) && buffer[0] == std::byte{ 0xCC });
+    dynamic_assert(new_order.render(buffer));
+    Patch<ex::NewOrder> patch{ std::span(buffer).subspan(sizeof(ex::messageHeader)) };
+    patch.set<"orderId">(1234);
+    patch.set<"quantity">(100);
+    MessageView<ex::messageHeader> header(buffer);
+    auto decoded = header.valid() ? MessageView<ex::NewOrder>(header.tail()).get() : ex::NewOrder{};
+    dynamic_assert(header.valid() && header.value<&ex::messageHeader::templateId>() == ex::NewOrder::templateId && patch.dirty_count() == 2);
+    dynamic_assert(decoded.orderId() == 1234 && decoded.quantity() == 100 && decoded.execInst() == ex::ExecInst::Hidden && decoded.price.mantissa() == bounds<int64_t>::nullValue);
+
+    test_order_frame frame;
+    new_order.render(frame);
+    dynamic_assert(frame.header.blockLength() == ex::NewOrder::blockLength && frame.order.orderId() == 0);
+}
+
+void test_decimal()
+{
+    namespace ex = example::orders;
+    using Price = Decimal<BigEndian<Optionull<int64_t>>, ConstantExponent<-4>>;
+    using Amount = Decimal<le_int32_t, LittleEndian<int8_t>>;
+    static_assert(sizeof(Price) == 8 && sizeof(Amount) == 5);
+    static_assert(decimal<Price> && decimal<Amount> && decimal<ex::Decimal> && !decimal<ex::messageHeader>);
+    static_assert(has_constant_exponent<Price> && has_constant_exponent<ex::Decimal> && !has_constant_exponent<Amount>);
+
+    // unsigned mantissas do not fit in the int64_t the conversions use
+    struct Unsigned { le_uint64_t mantissa; LittleEndian<int8_t> exponent; };
+    static_assert(!decimal<Unsigned>);
+
+    // conversions
+    static_assert([]
+    {
+        Price price;
+        int64_t scaled = 0;
+        bool ok = price.is_null() && !price.to_scaled(-4, scaled);
+        ok &= price.from_scaled(12345, -2) && price.mantissa() == 1234500;
+        ok &= price.to_scaled(-2, scaled) && scaled == 12345 && price.to_scaled(0, scaled) && scaled == 123;
+        ok &= price.from_scaled(-15, -5) && price.mantissa() == -1;               // truncated toward zero
+        ok &= !price.from_scaled(bounds<int64_t>::maxValue, 0) && price.mantissa() == -1;
+        ok &= price.from_scaled(1, 0) && !price.to_scaled(-20, scaled) && price.to_scaled(-18, scaled) && scaled == 1'000'000'000'000'000'000;
+        Amount amount{ -7, 3 };
+        ok &= amount.to_scaled(0, scaled) && scaled == -7000 && amount.from_scaled(42, -1) && amount.exponent() == -1 && !amount.from_scaled(1, 200);
+        return ok;
+    }());
+    Price price;
+    dynamic_assert(std::isnan(price.to_double()));
+    price.from_scaled(-12345, -3);
+    dynamic_assert(price.to_double() == -12.345);
+
+    // comparisons across exponents, nulls are unordered
+    static_assert([]
+    {
+        Price a;
+        Amount b{ 15, -1 };
+        bool ok = !(a < b) && !(a >= b) && a != b && (a <=> b) == std::partial_ordering::unordered;
+        a.from_scaled(15000, -4);
+        ok &= a == b && !(a < b) && b == a;
+        b.exponent = 1;  // 150
+        ok &= a < b && b > a;
+        b = Amount{ bounds<int32_t>::maxValue, 10 };  // beyond any int64_t at exponent -4
+        ok &= a < b && Amount{ -1, 100 } < a;
+        return ok;
+    }());
+
+    // generated composites
+    ex::NewOrder order;
+    dynamic_assert(is_null(order.price) && compare_decimals(order.price, price) == std::partial_ordering::unordered);
+    dynamic_assert(from_scaled(order.price, 25, -1) && order.price.mantissa() == 25000 && to_double(order.price) == 2.5 && price < order.price);
+
+    // batches
+    std::vector<Price> prices(1000);
+    std::vector<int64_t> scaled(prices.size());
+    for (size_t i = 0; i < prices.size(); ++i)
+        if (i % 7 != 0)
+            prices[i].from_scaled(static_cast<int64_t>(i) * 100 - 5000, -4);
+    dynamic_assert(to_scaled(std::span<const Price>(prices), std::span(scaled), -2, -1) == prices.size() - 143);
+    dynamic_assert(scaled[0] == -1 && scaled[1] == -49 && scaled[999] == 949 && scaled[700] == -1);
+
+    std::vector<Amount> amounts(3);
+    const int64_t values[] = { 1, bounds<int64_t>::maxValue, -3 };
+    dynamic_assert(from_scaled(std::span(values), -2, std::span(amounts)) == 2 && amounts[2].mantissa() == -3 && amounts[2].exponent() == -2);
+    dynamic_assert(to_scaled(std::span<const Amount>(amounts).first(1), std::span(scaled), -3) == 1 && scaled[0] == 10);
+
+    std::vector<ex::Decimal> generated(2);
+    generated[1].mantissa = 5;
+    double doubles[2];
+    dynamic_assert(from_scaled(std::span<const int64_t>(values).first(1), 2, std::span(generated)) == 1 && generated[0].mantissa() == 1'000'000);
+    dynamic_assert(to_double(std::span<const ex::Decimal>(generated), std::span(doubles)) == 2 && doubles[0] == 100 && doubles[1] == 0.0005);
+}
+
+void test_decoded()
+{
+    using D = Decoded<test_decoded_message>;
+    static_assert(std::is_same_v<host_t<be_uint32_t>, Type<uint32_t>>);
+    static_assert(std::is_same_v<host_t<BigEndian<Optionull<int16_t>>[5]>, Optionull<int16_t>[5]>);
+    static_assert(std::is_same_v<host_t<test_group_entry_mirror[2]>, Decoded<test_group_entry_mirror>[2]>);
+    static_assert(std::is_same_v<host_t<test_group_entry>, test_group_entry>);  // no mirror, copied as is
+    static_assert(alignof(D) == alignof(uint32_t));
+
+    test_decoded_message msg;
+    msg.a = 0x01020304u;
+    msg.b[1] = -2;
+    msg.b[4] = 300;
+    msg.c = "ab";
+    msg.d[1] = { 7, 8 };
+
+    const auto d = decode(msg);
+    dynamic_assert(d.a() == 0x01020304u && d.c() == "ab" && d.d[1].id() == 7);
+    dynamic_assert(d.b[0].is_not_set() && d.b[1]() == -2 && d.b[4]() == 300 && !d.b[4].is_not_set());
+
+    auto changed = d;
+    changed.b[0] = 5;
+    const auto encoded = encode<test_decoded_message>(changed);
+    dynamic_assert(encoded.b[0]() == 5 && encoded.b[1]() == -2 && encoded.a() == 0x01020304u);
+    test_decoded_message same;
+    encode(d, same);
+    dynamic_assert(memcmp(&same, &msg, sizeof(msg)) == 0);
+
+    const test_group_entry_mirror entries[2] = { { 1 }, { 2 } };
+    Decoded<test_group_entry_mirror> decoded_entries[2];
+    decode_member(entries, decoded_entries);
+    dynamic_assert(decoded_entries[0].id() == 1 && decoded_entries[1].id() == 2);
+}
+
+void test_var_data()
+{
+    using VarString = VarData<LittleEndian<uint16_t>>;
+    using VarString8 = VarData<BigEndian<uint8_t>, char8_t>;
+    static_assert(VarString::max_length == 65534);
+    static_assert(VarStringEncoding<>::max_length == 1073741824);
+
+    std::byte buf[64];
+    auto cursor = VarString::encode(buf, std::string_view("free text"));
+    cursor = VarString::encode(cursor, std::string_view());
+    auto remaining = VarString8::encode(std::span<std::byte>(cursor, buf + sizeof(buf)), std::u8string_view(u8"utf8"));
+    dynamic_assert(remaining.data() == cursor + VarString8::encoded_size(4));
+    std::byte large[512];
+    dynamic_assert(VarString8::encode(std::span<std::byte>(large), std::u8string_view(std::u8string(300, u8'x'))).data() == nullptr);  // > max_length
+    dynamic_assert(VarString8::encode(remaining.first(4), std::u8string_view(u8"utf8")).data() == nullptr);
+
+    const uint8_t expected[] = { 9, 0, 'f', 'r', 'e', 'e', ' ', 't', 'e', 'x', 't', 0, 0, 4, 'u', 't', 'f', '8' };
+    dynamic_assert(memcmp(buf, expected, sizeof(expected)) == 0);
+
+    VarString a(std::span<const std::byte>(buf, sizeof(expected)));
+    dynamic_assert(a.valid() && a() == "free text" && a.bytes().size() == 9 && a.byte_size() == 11);
+    VarString b(a.tail());
+    dynamic_assert(b.valid() && b.empty() && b.to_string_view().empty());
+    VarString8 c(b.tail());
+    dynamic_assert(c.valid() && c() == u8"utf8" && c.tail().empty());
+    dynamic_assert(c.bytes().data() == reinterpret_cast<const std::byte*>(buf + 14));  // no copy
+
+    VarString truncated(std::span<const std::byte>(buf, 10));
+    dynamic_assert(!truncated.valid() && truncated.empty());
+}
+
+#pragma pack(push)
+#pragma pack(1)
+
+template<uint16_t Id>
+struct test_identified_message
+{
+    constexpr static uint16_t templateId = Id;
+    le_uint32_t value;
+};
+
+#pragma pack(pop)
+
+template<uint16_t... Ids>
+void test_dispatcher_ids(bool is_dense)
+{
+    using Header = MessageHeader<>;
+    using D = Dispatcher<Header, test_identified_message<Ids>...>;
+    static_assert(sizeof(Header) == 8);
+    dynamic_assert(D::is_dense == is_dense);
+
+    for (uint16_t id : { Ids... })
+    {
+        std::vector<std::byte> buf;
+        append(buf, Header{ static_cast<uint16_t>(sizeof(le_uint32_t) + 2), id, 1, 0 });
+        append(buf, le_uint32_t(id * 3u), sizeof(le_uint32_t) + 2);
+        append(buf, le_uint16_t(0xBEEF));
+
+        uint32_t seen = 0;
+        size_t tail_size = 0;
+        auto handler = [&]<uint16_t I>(const test_identified_message<I>& msg, std::span<const std::byte> tail)
+        {
+            dynamic_assert(I == id);
+            seen = msg.value();
+            tail_size = tail.size();
+        };
+        dynamic_assert(D::dispatch(buf, handler));
+        dynamic_assert(seen == id * 3u && tail_size == 2);
+
+        dynamic_assert(!D::dispatch(std::span<const std::byte>(buf).first(sizeof(Header) + 1), handler));  // too small
+        buf[2] = std::byte{0xFF};  // unknown templateId
+        buf[3] = std::byte{0xFE};
+        dynamic_assert(!D::dispatch(buf, handler));
+    }
+}
+
+void test_dispatcher()
+{
+    test_dispatcher_ids<7>(true);
+    test_dispatcher_ids<3, 1, 2, 5>(true);
+    test_dispatcher_ids<1000, 3, 65000, 17, 4242, 99, 12345>(false);
+
+    // handler without tail
+    using Header = MessageHeader<BigEndian>;
+    std::vector<std::byte> buf;
+    append(buf, Header{ static_cast<uint16_t>(sizeof(le_uint32_t)), 2, 1, 0 });
+    append(buf, le_uint32_t(42));
+    uint32_t seen = 0;
+    dynamic_assert((Dispatcher<Header, test_identified_message<1>, test_identified_message<2>>::dispatch(buf,
+        [&](const auto& msg) { seen = msg.value(); })));
+    dynamic_assert(seen == 42);
+}
+
+void test_schema()
+{
+    namespace ex = example::orders;
+    static_assert(ex::schemaId == 42 && ex::NewOrder::templateId == 1);
+    static_assert(sizeof(ex::NewOrder) == ex::NewOrder::blockLength && ex::NewOrder::blockLength == 49);
+    static_assert(ex::NewOrder::flags_offset == 32);  // explicit offset, after 1 byte of padding
+    static_assert(ex::CancelOrder::blockLength == 16);  // declared blockLength
+    static_assert(ex::MassQuote::entries::blockLength == 24);
+    static_assert(ex::NewOrder::venue() == "XLON");
+    static_assert(field_count<ex::NewOrder> == 9 && field_t<ex::NewOrder, 7>::name == "flags" && field_t<ex::NewOrder, 7>::offset == 32);
+    static_assert(field_t<ex::MassQuote::entries, 2>::has_attributes && field_t<ex::NewOrder, 8>::extent == 2);
+    static_assert(ex::Decimal::exponent == -4);
+    static_assert(ex::Quantity::minValue == 1 && ex::Quantity::maxValue == 1000000);
+    static_assert(ex::NewOrder::text_data::max_length == 1073741824);
+    static_assert(std::is_same_v<ex::MassQuote::legs_group, GroupCursor<ex::groupSizeEncoding, ex::MassQuote::legs>>);
+
+    std::vector<std::byte> buf;
+    append(buf, ex::messageHeader{ ex::NewOrder::blockLength, ex::NewOrder::templateId, ex::schemaId, ex::schemaVersion });
+    ex::NewOrder order{};
+    order.orderId = 1234;
+    order.symbol = "ABCD";
+    order.side = ex::Side::Sell;
+    order.quantity = 100;
+    order.price.mantissa = 1012500;
+    order.execInst = ex::ExecInst::Hidden;
+    order.timestamps[1] = 5;
+    append(buf, order);
+    std::byte text[16];
+    auto text_end = ex::NewOrder::text_data::encode(text, std::string_view("hello"));
+    buf.insert(buf.end(), text, text_end);
+
+    const auto decoded = decode(order);  // generated mirror
+    dynamic_assert(decoded.orderId() == 1234 && decoded.symbol() == "ABCD" && decoded.side() == ex::Side::Sell && decoded.price.mantissa() == 1012500);
+    dynamic_assert(decoded.timeInForce.is_not_set() && decoded.flags.is_not_set() && decoded.timestamps[1]() == 5);
+    const auto reencoded = encode<ex::NewOrder>(decoded);
+    dynamic_assert(memcmp(&order, &reencoded, sizeof(order)) == 0);
+    dynamic_assert(order.timeInForce() == decltype(order.timeInForce)::nullValue && order.flags() == 0);
+    auto invalid_order = order;
+    invalid_order.side = static_cast<ex::Side>('3');  // not a validValue
+    invalid_order.quantity = 0;  // below minValue
+    dynamic_assert(is_valid(order) && validate(invalid_order) == 0b1100u);
+    bool seen = false;
+    auto handler = [&](const auto& msg, std::span<const std::byte> tail)
+    {
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(msg)>, ex::NewOrder>)
+        {
+            ex::NewOrder::text_data data(tail);
+            seen = msg.orderId() == 1234 && msg.symbol() == "ABCD" && msg.side() == ex::Side::Sell && msg.quantity() == 100 &&
+                   msg.price.mantissa() == 1012500 && msg.timestamps[1]() == 5 && data() == "hello";
+        }
+    };
+    dynamic_assert(ex::MessageDispatcher::dispatch(buf, handler) && seen);
+
+    // MassQuote: quoteId, 1 entry (blockLength 24), 2 legs with 0 and 1 fills, note
+    using Dim = ex::groupSizeEncoding;
+    std::vector<std::byte> quote;
+    append(quote, ex::MassQuote{ 77 });
+    append(quote, Dim{ ex::MassQuote::entries::blockLength, 1 });
+    append(quote, ex::MassQuote::entries{ "XYZ", { 99 }, {}, {} });
+    append(quote, Dim{ ex::MassQuote::legs::blockLength, 2 });
+    append(quote, ex::MassQuote::legs{ -1 });
+    append(quote, Dim{ ex::MassQuote::legs::fills::blockLength, 0 });
+    append(quote, ex::MassQuote::legs{ 2 });
+    append(quote, Dim{ ex::MassQuote::legs::fills::blockLength, 1 });
+    append(quote, ex::MassQuote::legs::fills{ 500 });
+    append(quote, le_uint32_t(0));
+
+    std::span<const std::byte> rest(quote);
+    dynamic_assert(reinterpret_cast<const ex::MassQuote*>(rest.data())->quoteId() == 77);
+    ex::MassQuote::entries_group entries(rest.subspan(ex::MassQuote::blockLength));
+    dynamic_assert(entries.size() == 1 && entries[0].symbol() == "XYZ" && entries[0].bid.mantissa() == 99 && entries[0].bidSize() == bounds<uint32_t>::nullValue);
+    ex::MassQuote::legs_group legs(entries.tail());
+    uint32_t fills = 0;
+    while (legs.next())
+    {
+        ex::MassQuote::legs::fills_group leg_fills(legs.nested());
+        for (const auto& fill : leg_fills)
+            fills += fill.quantity();
+        legs.resume(leg_fills.tail());
+    }
+    ex::MassQuote::note_data note(legs.tail());
+    dynamic_assert(fills == 500 && note.valid() && note.empty() && note.tail().empty());
+}
+
+void test_indexed_message()
+{
+    namespace ex = example::orders;
+    using Indexed = IndexedMessage<ex::MassQuote>;
+    static_assert(Indexed::section_count == 3 && std::is_same_v<Indexed::section_t<1>, ex::MassQuote::legs_group>);
+    static_assert(std::is_same_v<ex::MassQuote::legs::sections, Sections<Section<"fills", ex::MassQuote::legs::fills_group>>>);
+    static_assert(IndexedMessage<ex::CancelOrder>::section_count == 0);
+
+    // quoteId, 2 entries, 2 legs with 1 and 2 fills, note, then the next message
+    using Dim = ex::groupSizeEncoding;
+    std::vector<std::byte> quote;
+    append(quote, ex::MassQuote{ 77 });
+    append(quote, Dim{ ex::MassQuote::entries::blockLength, 2 });
+    append(quote, ex::MassQuote::entries{ "XYZ", { 99 }, {}, {} });
+    append(quote, ex::MassQuote::entries{ "ABC", { 98 }, { 10 }, {} });
+    append(quote, Dim{ ex::MassQuote::legs::blockLength, 2 });
+    append(quote, ex::MassQuote::legs{ -1 });
+    append(quote, Dim{ ex::MassQuote::legs::fills::blockLength, 1 });
+    append(quote, ex::MassQuote::legs::fills{ 100 });
+    append(quote, ex::MassQuote::legs{ 2 });
+    append(quote, Dim{ ex::MassQuote::legs::fills::blockLength, 2 });
+    append(quote, ex::MassQuote::legs::fills{ 200 });
+    append(quote, ex::MassQuote::legs::fills{ 300 });
+    std::byte note_bytes[16];
+    auto note_end = ex::MassQuote::note_data::encode(note_bytes, std::string_view("hi"));
+    quote.insert(quote.end(), note_bytes, note_end);
+    const auto message_size = quote.size();
+    append(quote, ex::MassQuote{ 78 });
+
+    Indexed msg(quote);
+    dynamic_assert(msg.valid() && msg.message().value<&ex::MassQuote::quoteId>() == 77);
+    dynamic_assert(msg.offset(0) == 8 && msg.offset(1) == 8 + 4 + 2 * 24 && msg.offset(3) == message_size);
+    dynamic_assert(msg.byte_size() == message_size && msg.tail().size() == sizeof(ex::MassQuote));
+
+    // any section, in any order
+    auto note = msg.section<"note">();
+    dynamic_assert(note.valid() && note() == "hi" && note.tail().empty());
+    auto entries = msg.section<"entries">();
+    dynamic_assert(entries.size() == 2 && entries[1].symbol() == "ABC" && entries[1].bidSize() == 10 && entries.tail().empty());
+    auto legs = msg.section<1>();
+    uint32_t fills = 0;
+    while (legs.next())
+    {
+        ex::MassQuote::legs::fills_group leg_fills(legs.nested());
+        for (const auto& fill : leg_fills)
+            fills += fill.quantity();
+        legs.resume(leg_fills.tail());
+    }
+    dynamic_assert(fills == 600 && legs.valid() && legs.tail().empty() && msg.section_bytes(1).size() == 4 + 2 + 4 + 4 + 2 + 4 + 8);
+
+    // truncated anywhere
+    for (size_t n = 0; n < message_size; ++n)
+        dynamic_assert(!Indexed(std::span(quote).first(n)).valid());
+    dynamic_assert(Indexed(std::span(quote).first(message_size)).tail().empty() && Indexed().byte_size() == 0);
+}
+
+void test_symbol_table()
+{
+    using Symbols = SymbolTable<ArrayChar<8>, 100>;
+    static_assert(Symbols::group_count == 8 && Symbols::slot_count == 128);
+
+    // known set of symbols, built at compile time
+    constexpr ArrayChar<8> universe[] = { "AAPL", "MSFT", "GOOG", "AMZN", "TSLA", "NVDA", "META", "MSFT", "IBM", "ORCL12345" };
+    constexpr Symbols known(universe);
+    static_assert(known.size() == 9 && known.max_probe_length() == 1);
+    static_assert(known.find("MSFT") == 1 && known.find("IBM") == 7 && known.find("ORCL1234") == 8 && known.find("INTC") == Symbols::npos);
+    static_assert(known.symbol(2) == ArrayChar<8>("GOOG"));
+    dynamic_assert(known.find(ArrayChar<8>("NVDA")) == 5 && !known.contains(ArrayChar<8>("NVD")) && !known.contains(ArrayChar<8>()));
+
+    // bytes after the first zero are ignored
+    ArrayChar<8> padded("IBM");
+    padded.elems[5] = 'X';
+    dynamic_assert(known.find(padded) == 7);
+
+    // interning until full
+    Symbols symbols;
+    char name[9];
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        std::snprintf(name, sizeof(name), "S%u", i * 7919u);
+        dynamic_assert(symbols.insert(ArrayChar<8>(name)) == i);
+    }
+    dynamic_assert(symbols.size() == 100 && symbols.insert(ArrayChar<8>("NEW")) == Symbols::npos && symbols.insert(ArrayChar<8>("S7919")) == 1);
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        std::snprintf(name, sizeof(name), "S%u", i * 7919u);
+        dynamic_assert(symbols.find(ArrayChar<8>(name)) == i && symbols.symbol(i).to_string_view() == name);
+    }
+    dynamic_assert(!symbols.contains(ArrayChar<8>("S1")));
+    symbols.clear();
+    dynamic_assert(symbols.empty() && symbols.find(ArrayChar<8>("S0")) == Symbols::npos && symbols.insert(ArrayChar<8>("S1")) == 0);
+
+    // two words
+    SymbolTable<ArrayChar<16>, 4> wide;
+    dynamic_assert(wide.insert(ArrayChar<16>("ABCDEFGH")) == 0 && wide.insert(ArrayChar<16>("ABCDEFGHIJKLMNOP")) == 1 && wide.insert(ArrayChar<16>("ABCDEFGHI")) == 2);
+    dynamic_assert(wide.find(ArrayChar<16>("ABCDEFGHI")) == 2 && wide.find(ArrayChar<16>("ABCDEFGHIJ")) == decltype(wide)::npos);
+    static_assert(SymbolTable<ArrayChar<16>, 4>(std::span<const ArrayChar<16>>()).empty());
+}
+
+void test_ascii_number()
+{
+    // kernels
+    static_assert(detail_simd::swar_all_digits(0x3938373635343332ull) && !detail_simd::swar_all_digits(0x3938373635343A32ull) && !detail_simd::swar_all_digits(0x2F38373635343332ull));
+    static_assert(detail_simd::swar_parse_digits8(0x3837363534333231ull) == 12345678 && detail_simd::swar_format_digits8(12345678) == 0x3837363534333231ull);
+    static_assert(detail_simd::swar_format_digits8(90000099) == 0x3939303030303039ull && detail_simd::swar_format_digits8(0) == 0x3030303030303030ull);
+    uint64_t parsed = 0;
+    std::byte digits[16];
+    for (uint64_t x : { 0ull, 7ull, 1234567890123456ull, 9999999999999999ull, 1000000000000000ull, 4294967296ull })
+    {
+        detail_simd::format_digits16(x, digits);
+        dynamic_assert(detail_simd::parse_digits16(digits, parsed) && parsed == x);
+    }
+    digits[9] = std::byte{ ' ' };
+    dynamic_assert(!detail_simd::parse_digits16(digits, parsed));
+
+    // parsing, with any padding
+    int64_t value = 0;
+    dynamic_assert(to_integer(ArrayChar<8>("00001500"), value) && value == 1500);
+    dynamic_assert(to_integer(ArrayChar<8>("   -1500"), value) && value == -1500);
+    dynamic_assert(to_integer(ArrayChar<8>("+1500   "), value) && value == 1500);
+    dynamic_assert(to_integer(ArrayChar<8>("1500"), value) && value == 1500);  // zero bytes
+    dynamic_assert(to_integer(ArrayChar<20>("-9223372036854775808"), value) && value == std::numeric_limits<int64_t>::min());
+    dynamic_assert(to_integer(ArrayChar<32>("00000000000009223372036854775807"), value) && value == std::numeric_limits<int64_t>::max());
+    value = 42;
+    for (const char* invalid : { "", "        ", "-", "12 34", "12a4", "--12", "1.5", "9223372036854775808" })
+        dynamic_assert(!to_integer(ArrayChar<20>(std::string_view(invalid)), value) && value == 42);
+
+    uint64_t u64 = 0;
+    uint8_t u8 = 0;
+    int16_t i16 = 0;
+    dynamic_assert(to_integer(ArrayChar<20>("18446744073709551615"), u64) && u64 == std::numeric_limits<uint64_t>::max());
+    dynamic_assert(!to_integer(ArrayChar<20>("18446744073709551616"), u64) && !to_integer(ArrayChar<24>("1000000000000000000000"), u64));
+    dynamic_assert(!to_integer(ArrayChar<4>("-1"), u64) && to_integer(ArrayChar<4>("255"), u8) && u8 == 255 && !to_integer(ArrayChar<4>("256"), u8));
+    dynamic_assert(to_integer(ArrayChar<8, true>("-32768"), i16) && i16 == -32768 && !to_integer(ArrayChar<8>("32768"), i16));
+
+    // decimals
+    using Price = Decimal<BigEndian<Optionull<int64_t>>, ConstantExponent<-4>>;
+    Price price;
+    dynamic_assert(to_decimal(ArrayChar<10>("  -12.50"), price) && price.mantissa() == -125000);
+    dynamic_assert(to_decimal(ArrayChar<10>("0.123456"), price) && price.mantissa() == 1234);  // truncated
+    dynamic_assert(to_decimal(ArrayChar<10>(".5"), price) && price.mantissa() == 5000 && to_decimal(ArrayChar<10>("7."), price) && price.mantissa() == 70000);
+    dynamic_assert(!to_decimal(ArrayChar<10>("1.2.3"), price) && !to_decimal(ArrayChar<10>("."), price) && price.mantissa() == 70000);
+    Decimal<le_int64_t, LittleEndian<int8_t>> amount;
+    dynamic_assert(to_decimal(ArrayChar<24>("123456789012.3456789"), amount) && amount.mantissa() == 1234567890123456789 && amount.exponent() == -7);
+
+    // formatting
+    ArrayChar<8> field;
+    dynamic_assert(from_integer(field, 1500) && field.to_string_view() == "00001500");
+    dynamic_assert(from_integer(field, -1500, Padding::zero) && field.to_string_view() == "-0001500");
+    dynamic_assert(from_integer(field, -1500, Padding::space) && field.to_string_view() == "   -1500");
+    dynamic_assert(from_integer(field, 1500u, Padding::trailing_space) && field.to_string_view() == "1500    ");
+    dynamic_assert(from_integer(field, int8_t{ -128 }, Padding::trailing_null) && field.to_string_view() == "-128" && field.elems[7] == 0);
+    dynamic_assert(from_integer(field, 99999999) && !from_integer(field, 100000000) && !from_integer(field, -10000000) && field.to_string_view() == "99999999");
+    ArrayChar<21, true> wide;
+    dynamic_assert(from_integer(wide, std::numeric_limits<int64_t>::min(), Padding::space) && wide.to_string_view() == "-9223372036854775808");
+    dynamic_assert(from_integer(wide, std::numeric_limits<uint64_t>::max()) && wide.to_string_view() == "18446744073709551615");
+    dynamic_assert(from_integer(wide, uint64_t{ 0 }, Padding::space) && wide.to_string_view() == std::string(19, ' ') + "0" && to_integer(wide, u64) && u64 == 0);
+
+    // round trips
+    for (int64_t x = -999'999'999'999'999; x < 1'000'000'000'000'000; x += (x < 0 ? -x / 2 : x) + 12345)
+    {
+        ArrayChar<16> text;
+        dynamic_assert(from_integer(text, x, static_cast<Padding>(x & 3)) && to_integer(text, value) && value == x);
+    }
 }
 
 void tests()
@@ -337,6 +1772,7 @@ void tests()
     static_assert(std::is_same_v<decltype(ArrayChar<5>().to_string_view())::value_type, char>);
     static_assert(std::is_same_v<decltype(ArrayChar8<5>().to_string_view())::value_type, char8_t>);
     test_array<char>::test();
+    test_array_short(std::string("test") + "me");
     test_array<char8_t>::test();
 
     test_type<char8_t>();
@@ -351,7 +1787,38 @@ void tests()
     test_type<float>();
     test_type<double>();
 
+    test_bulk<uint8_t>();
+    test_bulk<int16_t>();
+    test_bulk<uint32_t>();
+    test_bulk<uint64_t>();
+    test_bulk<float>();
+    test_bulk<double>();
+    test_bswap_isa<2>();
+    test_bswap_isa<4>();
+    test_bswap_isa<8>();
+
     test_messages();
+    test_groups();
+    test_message_view();
+    test_capture();
+    test_net();
+    test_pcap();
+    test_bitfield();
+    test_checksum();
+    test_patch();
+    test_prototype();
+    test_decimal();
+    test_reflection();
+    test_validate();
+    test_columns();
+    test_interleave();
+    test_decoded();
+    test_var_data();
+    test_dispatcher();
+    test_schema();
+    test_indexed_message();
+    test_symbol_table();
+    test_ascii_number();
 }
 
 }  // namespace openmsg